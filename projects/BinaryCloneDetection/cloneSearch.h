@@ -0,0 +1,78 @@
+#ifndef CLONESEARCH_H
+#define CLONESEARCH_H
+
+#include <vector>
+#include <string>
+#include <stdint.h>
+#include <stddef.h>
+
+// The compressed signature vectors of a clone detection database, held in one contiguous buffer so
+// that scanning them does not chase a pointer (or a database row) per vector.
+class VectorArena {
+  public:
+  struct Entry {
+    int64_t row;                        // row_number in the vectors table
+    int64_t functionId;
+    int64_t indexWithinFunction;
+    size_t sumOfCounts;                 // L1 norm of the vector
+    size_t offset;                      // position of the compressed vector in the buffer
+    size_t size;                        // size of the compressed vector
+  };
+
+  VectorArena(): dimension(0) {}
+
+  void reserve(size_t nVectors, size_t nBytes) {entries.reserve(nVectors); bytes.reserve(nBytes);}
+  void add(int64_t row, int64_t functionId, int64_t indexWithinFunction, const uint8_t* compressedData, size_t compressedDataSize);
+
+  size_t size() const {return entries.size();}
+  const Entry& operator[](size_t i) const {return entries[i];}
+  const uint8_t* data(size_t i) const {return bytes.empty() ? NULL : &bytes[0] + entries[i].offset;}
+
+  // Uncompressed length of the vectors (the largest of all the vectors added).
+  size_t getDimension() const {return dimension;}
+
+  private:
+  std::vector<uint8_t> bytes;
+  std::vector<Entry> entries;
+  size_t dimension;
+};
+
+struct LshParameters {
+  size_t maxDistance;                   // vectors at most this far apart (L1) are clones
+  size_t tables;                        // number of independent hash tables
+  size_t hashElements;                  // coordinates sampled per hash table (0 to choose from falseNegativeRate)
+  double falseNegativeRate;             // acceptable probability of missing a pair maxDistance apart
+  size_t threads;                       // worker threads used to process buckets
+  unsigned int seed;
+
+  LshParameters(): maxDistance(0), tables(20), hashElements(0), falseNegativeRate(0.1), threads(1), seed(0) {}
+};
+
+struct LshStatistics {
+  size_t hashElements;                  // coordinates sampled per hash table (as chosen if not given)
+  size_t candidatePairs;                // pairs sharing a bucket (after duplicate and norm pruning)
+  size_t distanceComputations;
+  size_t clonePairs;                    // pairs found within maxDistance
+  double hashSeconds, verifySeconds;
+
+  LshStatistics(): hashElements(0), candidatePairs(0), distanceComputations(0), clonePairs(0), hashSeconds(0.0), verifySeconds(0.0) {}
+};
+
+// Returns the largest value of each coordinate over all the vectors (getDimension() elements).
+std::vector<uint16_t> coordinateMaxima(const VectorArena& vectors);
+
+// Returns the number of sampled coordinates per table so that two vectors maxDistance apart land in
+// the same bucket of at least one of the tables with probability 1-falseNegativeRate.  totalRange is
+// the sum over all coordinates of the largest value of that coordinate.
+size_t chooseHashElements(size_t totalRange, size_t maxDistance, size_t tables, double falseNegativeRate);
+
+// Finds the vectors within maxDistance (L1) of each other using multi-table L1 locality sensitive
+// hashing, and returns the cluster number of each vector (the transitive closure of the clone
+// relation).  Vectors that are not a clone of any other vector are in a cluster by themselves.
+// If params.hashElements is 0, it is chosen with chooseHashElements.
+std::vector<size_t> findCloneClusters(const VectorArena& vectors, const LshParameters& params, LshStatistics* stats = NULL);
+
+// Same result as findCloneClusters without false negatives, by comparing all pairs of vectors (for testing).
+std::vector<size_t> findCloneClustersExhaustive(const VectorArena& vectors, size_t maxDistance);
+
+#endif // CLONESEARCH_H
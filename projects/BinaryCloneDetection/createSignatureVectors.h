@@ -14,8 +14,10 @@
 #include "sqlite3x.h"
 
 bool createVectorsForAllInstructions(SgNode* top, const std::string& filename, const std::string& functionName, int functionId, size_t windowSize, size_t stride, sqlite3x::sqlite3_connection& con); // Ignores function boundaries
-void createVectorsRespectingFunctionBoundaries(SgNode* top, const std::string& filename, size_t windowSize, size_t stride, sqlite3x::sqlite3_connection& con);
-void createVectorsNotRespectingFunctionBoundaries(SgNode* top, const std::string& filename, size_t windowSize, size_t stride, sqlite3x::sqlite3_connection& con);
+// These manage their own transactions (committing every few thousand rows), so they must not be called
+// inside one.  Vectors are computed on nThreads threads; only the calling thread writes to the database.
+void createVectorsRespectingFunctionBoundaries(SgNode* top, const std::string& filename, size_t windowSize, size_t stride, sqlite3x::sqlite3_connection& con, size_t nThreads = 1);
+void createVectorsNotRespectingFunctionBoundaries(SgNode* top, const std::string& filename, size_t windowSize, size_t stride, sqlite3x::sqlite3_connection& con, size_t nThreads = 1);
 void createDatabases(sqlite3x::sqlite3_connection& con);
 
 #endif // CREATE_CLONE_DETECTION_VECTORS_BINARY
@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <stdint.h>
+#include <stddef.h>
 
 std::vector<uint8_t> compressVector(const uint16_t data[], const size_t dataSize);
 void decompressVector(const uint8_t compressedData[], size_t compressedDataSize, uint16_t result[]);
@@ -15,6 +16,7 @@ size_t l1distance(const uint8_t compressedData[], size_t compressedDataSize, con
 double l2distanceSquared(const uint8_t compressedData[], size_t compressedDataSize, const uint16_t* const otherVector);
 size_t l1distanceC(const uint8_t compressedData[], const size_t compressedDataSize, const uint8_t otherVectorCompressedData[], const size_t otherVectorCompressedDataSize);
 double l2distanceSquaredC(const uint8_t compressedData[], const size_t compressedDataSize, const uint8_t otherVectorCompressedData[], const size_t otherVectorCompressedDataSize);
+size_t l1distanceDense(const uint16_t* a, const uint16_t* b, size_t size);
 void elementwiseMax(const uint8_t compressedData[], size_t compressedDataSize, uint16_t v[]);
 size_t computeL1Hash(const uint8_t compressedData[], size_t compressedDataSize, size_t hashElementCount, const size_t indexes[], const size_t compareValues[], const size_t coeffs[], size_t moduloValue);
 
@@ -84,6 +84,12 @@ void RuntimeSystem::readConfigFile()
                          || value_name == "on"
                          || value_name == "true"
                          );
+        else if (key == "shadowMemory")
+            memManager.setShadowMemory(  value_name == "1"
+                                      || value_name == "yes"
+                                      || value_name == "on"
+                                      || value_name == "true"
+                                      );
         else
         {
             RuntimeViolation::Type t = RuntimeViolation::getViolationByString(key);
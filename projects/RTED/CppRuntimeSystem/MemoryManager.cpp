@@ -4,6 +4,7 @@
 #include <typeinfo>
 
 #include "MemoryManager.h"
+#include "ShadowMemory.h"
 
 #include "CppRuntimeSystem.h"
 #include "rtedsync.h"
@@ -162,8 +163,12 @@ MemoryType::MemoryType(Location _addr, size_t _size, AllocKind ak, long blsz, co
 
 void MemoryType::resize( size_t new_size )
 {
-    assert( new_size >= getSize() );
+    const size_t old_size = getSize();
+
+    assert( new_size >= old_size );
     initdata.resize( new_size );
+
+    rtedRTS(this).getMemManager().shadowResize( *this, old_size );
 }
 
 MemoryType::Location MemoryType::endAddress() const
@@ -696,6 +701,9 @@ MemType* validateMembership(MemType* mt, Address addr, size_t size)
 
 MemoryType* MemoryManager::findContainingMem(Location addr, size_t size)
 {
+    // the page index replaces both the cache and the map
+    if (shadow) return shadow->findContainingMem(addr, size);
+
     MemoryType* res = memtypecache.findContainingMem(addr, size);
 
     if (!res)
@@ -711,6 +719,8 @@ MemoryType* MemoryManager::findContainingMem(Location addr, size_t size)
 const MemoryType*
 MemoryManager::findContainingMem(Location addr, size_t size) const
 {
+    if (shadow) return shadow->findContainingMem(addr, size);
+
     return ::validateMembership(findPossibleMemMatch(addr), addr, size);
 }
 
@@ -748,6 +758,9 @@ MemoryType* MemoryManager::allocateMemory(Location adrObj, size_t szObj, MemoryT
     MemoryType&               res = mem.insert(v).first->second;
 
     memtypecache.store(res);
+
+    if (shadow) shadowAllocation(res);
+
     return &res;
 }
 
@@ -883,6 +896,8 @@ void MemoryManager::freeMemory(MemoryType* m, MemoryType::AllocKind freekind)
     // remove entry from cache
     memtypecache.clear(*m);
 
+    if (shadow) shadow->release(*m);
+
     // successful free, erase allocation info from map
     mem.erase(m->beginAddress());
 
@@ -949,6 +964,9 @@ MemoryManager::checkLocation(Location addr, size_t size, RuntimeViolation::Type
 
 void MemoryManager::checkRead(Location addr, size_t size) const
 {
+    // common case: initialized memory within one allocation
+    if (shadow && shadow->isInitialized(addr, size)) return;
+
     const MemoryType* mt = checkLocation(addr, size, RuntimeViolation::INVALID_READ);
     assert(mt && ((mt->beginAddress() <= addr) || (!mt->blockSize())));
 
@@ -977,6 +995,12 @@ MemoryManager::checkWrite(Location addr, size_t size, const RsType* t)
       RuntimeSystem::instance().printMessage(msg.str());
     }
 
+    // untyped writes to initialized memory do not change the state
+    if (!t && shadow && shadow->isInitialized(addr, size))
+    {
+      return std::make_pair(shadow->findContainingMem(addr, size), false);
+    }
+
     bool           statuschange = false;
     MemoryType*    mt = ::checkLocation(*this, addr, size, RuntimeViolation::INVALID_WRITE);
 
@@ -1001,6 +1025,8 @@ MemoryManager::checkWrite(Location addr, size_t size, const RsType* t)
 
     const bool initmod = mt->initialize(ofs, size);
 
+    if (initmod && shadow) shadow->initialize(addr, size);
+
     if ( diagnostics::message(diagnostics::memory) )
     {
       RuntimeSystem::instance().printMessage("   ++ checkWrite done.");
@@ -1011,6 +1037,8 @@ MemoryManager::checkWrite(Location addr, size_t size, const RsType* t)
 
 bool MemoryManager::isInitialized(Location addr, size_t size) const
 {
+    if (shadow && shadow->isInitialized(addr, size)) return true;
+
     const MemoryType* mt = checkLocation(addr, size, RuntimeViolation::INVALID_READ);
 
     return mt->isInitialized(addr, size);
@@ -1293,6 +1321,72 @@ void MemoryManager::clearStatus()
 {
   mem.clear();
   memtypecache.clear();
+
+  if (shadow) shadow->clear();
+}
+
+MemoryManager::~MemoryManager()
+{
+  delete shadow;
+}
+
+void MemoryManager::setShadowMemory(bool enable)
+{
+#if WITH_UPC
+  // \pp \todo distributed allocations are not contiguous
+  enable = false;
+#endif /* WITH_UPC */
+
+  if (enable == isShadowMemoryEnabled()) return;
+
+  if (!enable)
+  {
+    delete shadow;
+    shadow = NULL;
+    return;
+  }
+
+  shadow = new ShadowMemory;
+
+  for (MemoryTypeSet::iterator it = mem.begin(); shadow && it != mem.end(); ++it)
+  {
+    shadowAllocation(it->second);
+  }
+}
+
+void MemoryManager::shadowAllocation(MemoryType& mt)
+{
+  assert(shadow);
+
+  if (shadow->covers(mt.lastValidAddress()))
+  {
+    shadow->allocate(mt);
+    return;
+  }
+
+  // an allocation outside the shadow would be missed by the page index
+  setShadowMemory(false);
+
+  if ( diagnostics::message(diagnostics::memory) )
+  {
+    std::stringstream msg;
+
+    msg << "  ***** shadow memory disabled, allocation not covered: " << mt.beginAddress();
+    RuntimeSystem::instance().printMessage(msg.str());
+  }
+}
+
+void MemoryManager::shadowResize(MemoryType& mt, size_t oldsize)
+{
+  if (!shadow) return;
+
+  if (shadow->covers(mt.lastValidAddress()))
+  {
+    shadow->extend(mt, oldsize);
+    return;
+  }
+
+  setShadowMemory(false);
 }
 
 
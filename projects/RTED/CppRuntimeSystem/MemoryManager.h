@@ -19,6 +19,7 @@
 
 
 class RuntimeSystem;
+struct ShadowMemory;
 class VariablesType;
 class RsType;
 class RsCompoundType;
@@ -200,9 +201,11 @@ struct MemoryManager
         typedef std::map<Location, MemoryType> MemoryTypeSet;
 
         MemoryManager()
-        : mem()
+        : mem(), shadow(NULL)
         {}
 
+        ~MemoryManager();
+
         /// \brief  Create a new allocation based on the parameters
         /// \return a pointer to the actual stored object (NULL in case something went wrong)
         MemoryType* allocateMemory(Location addr, size_t size, MemoryType::AllocKind kind, long blocksize, const SourceInfo& pos);
@@ -260,6 +263,15 @@ struct MemoryManager
         /// normally only needed for debug purposes
         void clearStatus();
 
+        /// \brief Switches the shadow memory on/off (default off)
+        ///        With shadow memory, reads and writes of initialized memory are
+        ///        checked without searching the allocation map, and allocations
+        ///        are looked up through a page index.
+        /// \note  not available for UPC (distributed allocations)
+        void setShadowMemory(bool enable);
+
+        bool isShadowMemoryEnabled() const { return shadow != NULL; }
+
         /// Returns the MemoryType which stores the allocation information which is
         /// registered for this addr, or NULL if nothing is registered
         MemoryType*       getMemoryType(Location addr);
@@ -301,9 +313,21 @@ struct MemoryManager
         /// Frees allocated memory, throws error when no allocation is managed at this addr
         void freeMemory(MemoryType* m, MemoryType::AllocKind);
 
+        /// Records a new allocation in the shadow memory
+        void shadowAllocation(MemoryType& mt);
+
+        /// Records that mt grew from oldsize (see MemoryType::resize)
+        void shadowResize(MemoryType& mt, size_t oldsize);
+
+        // not copyable
+        MemoryManager(const MemoryManager&);
+        MemoryManager& operator=(const MemoryManager&);
+
         MemoryTypeSet mem;
+        ShadowMemory* shadow;  ///< NULL, unless the shadow memory is enabled
 
         friend class CStdLibManager;
+        friend struct MemoryType;
 };
 
 std::ostream& operator<< (std::ostream &os, const MemoryManager & m);
@@ -0,0 +1,192 @@
+// vim:et sta sw=4 ts=4
+#include <algorithm>
+#include <cstring>
+
+#include "ShadowMemory.h"
+#include "MemoryManager.h"
+
+typedef ShadowTable<ShadowMemory::Shadow, 16> ShadowBytes;
+
+static inline
+size_t shadowIndex(Address addr)
+{
+    return reinterpret_cast<size_t>(addr.local);
+}
+
+/// orders the allocations of a page by their start address
+struct BeginAddressLess
+{
+    bool operator()(const MemoryType* mt, const char* addr) const
+    {
+        return mt->beginAddress().local < addr;
+    }
+
+    bool operator()(const char* addr, const MemoryType* mt) const
+    {
+        return addr < mt->beginAddress().local;
+    }
+};
+
+/// \brief calls op on the shadow bytes of [lo, hi), one leaf at a time
+template <class Op>
+static
+void forRange(ShadowBytes& shadow, size_t lo, size_t hi, Op op)
+{
+    while (lo < hi)
+    {
+        const size_t len = std::min(hi - lo, ShadowBytes::LEAFSIZE - (lo & (ShadowBytes::LEAFSIZE-1)));
+
+        op(&shadow.at(lo), len);
+        lo += len;
+    }
+}
+
+namespace
+{
+    struct Assign
+    {
+        ShadowMemory::Shadow bits;
+
+        explicit Assign(ShadowMemory::Shadow b) : bits(b) {}
+
+        void operator()(ShadowMemory::Shadow* s, size_t len) const
+        {
+            std::memset(s, bits, len);
+        }
+    };
+
+    struct Mark
+    {
+        ShadowMemory::Shadow bits;
+
+        explicit Mark(ShadowMemory::Shadow b) : bits(b) {}
+
+        void operator()(ShadowMemory::Shadow* s, size_t len) const
+        {
+            for (size_t i = 0; i < len; ++i) s[i] |= bits;
+        }
+    };
+}
+
+
+void ShadowMemory::allocate(MemoryType& mt)
+{
+    const size_t lo = shadowIndex(mt.beginAddress());
+    const size_t sz = mt.getSize();
+
+    forRange(shadow, lo, lo + sz, Assign(sbAllocated));
+    shadow.at(lo) |= sbChunkStart;
+
+    // memory can be allocated as initialized (e.g. globals)
+    for (size_t i = 0; i < sz; ++i)
+    {
+        if (mt.byteInitialized(i)) shadow.at(lo + i) |= sbInitialized;
+    }
+
+    addToPages(mt, lo, lo + sz);
+}
+
+void ShadowMemory::extend(MemoryType& mt, size_t oldsize)
+{
+    const size_t lo = shadowIndex(mt.beginAddress());
+
+    forRange(shadow, lo + oldsize, lo + mt.getSize(), Mark(sbAllocated));
+    addToPages(mt, lo + oldsize, lo + mt.getSize());
+}
+
+void ShadowMemory::release(const MemoryType& mt)
+{
+    const size_t lo = shadowIndex(mt.beginAddress());
+    const size_t hi = lo + mt.getSize();
+
+    forRange(shadow, lo, hi, Assign(0));
+
+    for (size_t page = lo >> PAGEBITS; page <= ((hi-1) >> PAGEBITS); ++page)
+    {
+        PageEntry&          entry = pages.at(page);
+        PageEntry::iterator pos = std::lower_bound(entry.begin(), entry.end(), mt.beginAddress().local, BeginAddressLess());
+
+        if (pos != entry.end() && *pos == &mt) entry.erase(pos);
+    }
+}
+
+void ShadowMemory::initialize(Address addr, size_t len)
+{
+    const size_t lo = shadowIndex(addr);
+
+    forRange(shadow, lo, lo + len, Mark(sbInitialized));
+}
+
+bool ShadowMemory::isInitialized(Address addr, size_t len) const
+{
+    const Shadow required = sbAllocated | sbInitialized;
+    size_t       lo = shadowIndex(addr);
+    const size_t hi = lo + len;
+
+    if (len == 0 || hi < lo || !ShadowBytes::covers(hi - 1)) return false;
+
+    // a chunk start is only allowed on the first byte,
+    //   otherwise the range spans two allocations
+    Shadow       mask = required;
+
+    while (lo < hi)
+    {
+        const Shadow* s = shadow.find(lo);
+
+        if (!s) return false;
+
+        const size_t  n = std::min(hi - lo, ShadowBytes::LEAFSIZE - (lo & (ShadowBytes::LEAFSIZE-1)));
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            if ((s[i] & mask) != required) return false;
+
+            mask = required | sbChunkStart;
+        }
+
+        lo += n;
+    }
+
+    return true;
+}
+
+bool ShadowMemory::covers(Address addr) const
+{
+    return ShadowBytes::covers(shadowIndex(addr));
+}
+
+MemoryType* ShadowMemory::findContainingMem(Address addr, size_t len) const
+{
+    const size_t     page = shadowIndex(addr) >> PAGEBITS;
+    const PageEntry* entry = pages.covers(page) ? pages.find(page) : NULL;
+
+    if (!entry || entry->empty()) return NULL;
+
+    // the allocation with the next lower or equal start address
+    PageEntry::const_iterator pos = std::upper_bound(entry->begin(), entry->end(), addr.local, BeginAddressLess());
+
+    if (pos == entry->begin()) return NULL;
+
+    MemoryType* mt = *(--pos);
+
+    return mt->containsMemArea(addr, len) ? mt : NULL;
+}
+
+void ShadowMemory::addToPages(MemoryType& mt, size_t lo, size_t hi)
+{
+    if (lo == hi) return;
+
+    for (size_t page = lo >> PAGEBITS; page <= ((hi-1) >> PAGEBITS); ++page)
+    {
+        PageEntry&          entry = pages.at(page);
+        PageEntry::iterator pos = std::lower_bound(entry.begin(), entry.end(), mt.beginAddress().local, BeginAddressLess());
+
+        if (pos == entry.end() || *pos != &mt) entry.insert(pos, &mt);
+    }
+}
+
+void ShadowMemory::clear()
+{
+    shadow.clear();
+    pages.clear();
+}
@@ -0,0 +1,145 @@
+// vim:et sta sw=4 ts=4
+#ifndef SHADOWMEMORY_H
+#define SHADOWMEMORY_H
+
+#include <vector>
+#include <cstddef>
+
+#include "rted_typedefs.h"
+
+struct MemoryType;
+
+/**
+ * \class ShadowTable
+ * \brief Direct-mapped table from an index (an address or a page number) to
+ *        an entry of type T. Leaves of 2^LEAFBITS entries are allocated on
+ *        first write and are value-initialized.
+ */
+template <class T, size_t LEAFBITS>
+struct ShadowTable
+{
+        static const size_t DIRBITS  = 16;
+        static const size_t TOPBITS  = 16;
+        static const size_t LEAFSIZE = size_t(1) << LEAFBITS;
+        static const size_t DIRSIZE  = size_t(1) << DIRBITS;
+        static const size_t TOPSIZE  = size_t(1) << TOPBITS;
+
+        ShadowTable()
+        : top(TOPSIZE, static_cast<T**>(NULL))
+        {}
+
+        ~ShadowTable() { clear(); }
+
+        /// true iff idx can be represented in the table
+        static bool covers(size_t idx)
+        {
+            return topIndex(idx) < TOPSIZE;
+        }
+
+        /// returns the entry for idx, or NULL if its leaf was never written
+        const T* find(size_t idx) const
+        {
+            T** dir = top[topIndex(idx)];
+            T*  l = dir ? dir[(idx >> LEAFBITS) & (DIRSIZE-1)] : NULL;
+
+            return l ? l + (idx & (LEAFSIZE-1)) : NULL;
+        }
+
+        /// returns the entry for idx, allocating its leaf if needed
+        T& at(size_t idx)
+        {
+            T**& dir = top[topIndex(idx)];
+
+            if (!dir) dir = new T*[DIRSIZE]();
+
+            T*& l = dir[(idx >> LEAFBITS) & (DIRSIZE-1)];
+
+            if (!l) l = new T[LEAFSIZE]();
+
+            return l[idx & (LEAFSIZE-1)];
+        }
+
+        void clear()
+        {
+            for (size_t i = 0; i < TOPSIZE; ++i)
+            {
+                if (!top[i]) continue;
+
+                for (size_t j = 0; j < DIRSIZE; ++j)
+                    delete[] top[i][j];
+
+                delete[] top[i];
+                top[i] = NULL;
+            }
+        }
+
+    private:
+        // two shifts, as LEAFBITS + DIRBITS can be the width of size_t
+        static size_t topIndex(size_t idx) { return (idx >> LEAFBITS) >> DIRBITS; }
+
+        std::vector<T**> top;
+
+        // not copyable
+        ShadowTable(const ShadowTable&);
+        ShadowTable& operator=(const ShadowTable&);
+};
+
+
+/**
+ * \class ShadowMemory
+ * \brief Direct-mapped shadow state of the memory tracked by MemoryManager.
+ *
+ * Each tracked byte has a shadow byte recording whether it is allocated,
+ * initialized, and the first byte of its allocation. Reads and writes of
+ * initialized memory are checked on the shadow alone. A page-level index
+ * lists the allocations overlapping each page, and replaces the search of
+ * the allocation map when the MemoryType containing an address is needed
+ * (e.g., for pointer targets).
+ *
+ * The shadow only answers the common case: MemoryType and the maps of
+ * MemoryManager remain authoritative, and any check the shadow cannot
+ * confirm is repeated on them to produce the diagnostics.
+ */
+struct ShadowMemory
+{
+        typedef unsigned char            Shadow;
+        typedef std::vector<MemoryType*> PageEntry;
+
+        enum ShadowBits { sbAllocated = 1, sbInitialized = 2, sbChunkStart = 4 };
+
+        static const size_t PAGEBITS = 12;
+
+        /// Records a new allocation (including its current initialization state)
+        void allocate(MemoryType& mt);
+
+        /// Records that the allocation mt grew from oldsize to its current size
+        void extend(MemoryType& mt, size_t oldsize);
+
+        /// Removes an allocation
+        void release(const MemoryType& mt);
+
+        /// Marks [addr, addr+len) as initialized
+        void initialize(Address addr, size_t len);
+
+        /// \return true iff [addr, addr+len) lies within a single allocation and is
+        ///         initialized. false means that the allocation maps need to be consulted.
+        bool isInitialized(Address addr, size_t len) const;
+
+        /// true iff addr can be represented in the shadow
+        bool covers(Address addr) const;
+
+        /// \return the allocation containing [addr, addr+len), NULL if there is none
+        /// \pre    covers(addr)
+        MemoryType* findContainingMem(Address addr, size_t len) const;
+
+        /// Forgets all allocations
+        void clear();
+
+    private:
+        void addToPages(MemoryType& mt, size_t lo, size_t hi);
+
+        ShadowTable<Shadow, 16>     shadow;
+        ShadowTable<PageEntry, 12>  pages;
+};
+
+#endif
@@ -454,6 +454,50 @@ void testMemAccess()
     CLEANUP
 }
 
+void testShadowMemory()
+{
+    TEST_INIT("Testing shadow memory");
+
+    MemoryManager& mm = rs.getMemManager();
+
+    createMemory(rs, asAddr(100), 10);
+    checkMemWrite(rs, asAddr(100), 10);
+
+    // allocations that exist before the shadow memory is enabled are tracked
+    mm.setShadowMemory(true);
+    assert(mm.isShadowMemoryEnabled());
+
+    checkMemRead(rs, asAddr(102), 8);
+    assert(mm.findContainingMem(asAddr(105), 5) == mm.getMemoryType(asAddr(100)));
+
+    // adjacent allocation, initialized memory on both sides
+    createMemory(rs, asAddr(110), 8000);
+    checkMemWrite(rs, asAddr(110), 8000);
+
+    try { checkMemRead(rs, asAddr(108), 4); }
+    TEST_CATCH(RuntimeViolation::INVALID_READ)
+
+    // an allocation that spans several pages
+    assert(mm.findContainingMem(asAddr(8100), 10) == mm.getMemoryType(asAddr(110)));
+    assert(mm.findContainingMem(asAddr(8105), 10) == NULL);
+
+    freeMemory(rs, asAddr(110));
+
+    try { checkMemRead(rs, asAddr(110), 4); }
+    TEST_CATCH(RuntimeViolation::INVALID_READ)
+
+    try { checkMemWrite(rs, asAddr(4000), 4); }
+    TEST_CATCH(RuntimeViolation::INVALID_WRITE)
+
+    freeMemory(rs, asAddr(100));
+    assert(mm.findContainingMem(asAddr(100), 1) == NULL);
+
+    CLEANUP
+
+    mm.setShadowMemory(false);
+    assert(!mm.isShadowMemoryEnabled());
+}
+
 void testMallocDeleteCombinations()
 {
     TEST_INIT("Testing malloc/delete, new/free and similar combinations");
@@ -1647,6 +1691,34 @@ extern "C"
           test_memcpy_strict_overlap();
           test_meminit_nullterm_included();
           test_range_overlap();
+  //~ //~
+          testShadowMemory();
+
+          // memory and pointer checks with the shadow memory
+          rs.getMemManager().setShadowMemory(true);
+
+          testSuccessfulMallocFree();
+          testFreeInsideBlock();
+          testInvalidFree();
+          testDoubleFree();
+          testDoubleAllocation();
+          testMemAccess();
+          testMallocDeleteCombinations();
+          testScopeFreesStack();
+          testLostMemRegion();
+          testPointerChanged();
+          testInvalidPointerAssign();
+          testPointerTracking();
+          testArrayAccess();
+          testDoubleArrayHeapAccess();
+          testMultidimensionalStackArrayAccess();
+          test_memcpy();
+          test_strcpy();
+          test_strlen();
+          test_meminit_nullterm_included();
+          test_range_overlap();
+
+          rs.getMemManager().setShadowMemory(false);
 
 
     rs.doProgramExitChecks();
@@ -127,6 +127,30 @@ struct RtedArray
 };
 
 
+/* -----------------------------------------------------------
+ * This class represents the elements arr[i] accessed by
+ * a counted loop
+ *   for (i = lb; i < ub; ++i) { ... arr[i] ... }
+ * Their bounds are checked once before the loop, by checking
+ * the first and the last element.
+ * -----------------------------------------------------------*/
+struct RtedArrayRange
+{
+  SgForStatement* loop;      // not owning
+  SgStatement*    stmt;      // first access in the loop body, not owning
+  SgExpression*   array;     // detached copy
+  SgExpression*   lb;        // detached copy
+  SgExpression*   ub;        // detached copy
+  bool            inclusive; // true, iff ub is the last index (i <= ub)
+
+  RtedArrayRange(SgForStatement* l, SgStatement* s, SgExpression* arr, SgExpression* lower, SgExpression* upper, bool incl)
+  : loop(l), stmt(s), array(arr), lb(lower), ub(upper), inclusive(incl)
+  {
+    ROSE_ASSERT(loop && stmt && array && lb && ub);
+  }
+};
+
+
 
 /* -----------------------------------------------------------
  * This class stores information about one Element
@@ -166,6 +166,10 @@ void RtedTransformation::executeTransformations()
     insertArrayAccessCall(ita->first, ita->second);
   }
 
+  if (RTEDDEBUG) std::cerr << "\n # Elements in array_range_checks  : " << array_range_checks.size() << std::endl;
+  BOOST_FOREACH( const RtedArrayRange& range, array_range_checks )
+    insertArrayRangeCheck(range);
+
   if (RTEDDEBUG) std::cerr << "\n # Elements in function_call_missing_def  : " << function_call_missing_def.size() << std::endl;
   BOOST_FOREACH( SgFunctionCallExp* fncall, function_call_missing_def )
     insertAssertFunctionSignature( fncall );
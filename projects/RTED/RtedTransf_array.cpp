@@ -452,7 +452,6 @@ struct ReadWriteContextFinder
 };
 
 
-static
 int read_write_context(const SgExpression* node)
 {
   ReadWriteContextFinder::Result res(0, node);
@@ -465,6 +464,24 @@ int read_write_context(const SgExpression* node)
   return res.first;
 }
 
+SgExprListExp*
+RtedTransformation::buildArrayAccessArgs(SgStatement* stmt, SgPntrArrRefExp* arrRefExp, int read_write_mask)
+{
+  // for contiguous array, base is at &array[0] whether on heap or on stack
+  SgPntrArrRefExp*  array_base = deepCopy(arrRefExp);
+
+  array_base -> set_rhs_operand(buildIntVal(0));  // \pp \todo \memleak
+
+  SgExprListExp*    arg_list = buildExprListExp();
+
+  appendAddress(arg_list, array_base);
+  appendAddressAndSize(arg_list, Whole, NULL, arrRefExp, NULL);
+  appendExpression(arg_list, buildIntVal(read_write_mask));
+  appendFileInfo(arg_list, stmt);
+
+  return arg_list;
+}
+
 void RtedTransformation::insertArrayAccessCall(SgStatement* stmt, SgPntrArrRefExp* arrRefExp, const RtedArray& array)
 {
   SgScopeStatement* scope = stmt->get_scope();
@@ -483,18 +500,7 @@ void RtedTransformation::insertArrayAccessCall(SgStatement* stmt, SgPntrArrRefEx
 
   // determine whether this array access is a read or write
   const int         read_write_mask = read_write_context(arrRefExp);
-
-  // for contiguous array, base is at &array[0] whether on heap or on stack
-  SgPntrArrRefExp*  array_base = deepCopy(arrRefExp);
-
-  array_base -> set_rhs_operand(buildIntVal(0));  // \pp \todo \memleak
-
-  SgExprListExp*    arg_list = buildExprListExp();
-
-  appendAddress(arg_list, array_base);
-  appendAddressAndSize(arg_list, Whole, NULL, arrRefExp, NULL);
-  appendExpression(arg_list, buildIntVal(read_write_mask));
-  appendFileInfo(arg_list, stmt);
+  SgExprListExp*    arg_list = buildArrayAccessArgs(stmt, arrRefExp, read_write_mask);
 
   insertCheck( ilBefore,
                stmt,
@@ -0,0 +1,592 @@
+#include <rose.h>
+
+// DQ (2/9/2010): Testing use of ROE to compile ROSE.
+#ifndef USE_ROSE
+
+#include <vector>
+#include <map>
+#include <set>
+#include <algorithm>
+
+#include <boost/foreach.hpp>
+
+#include <staticSingleAssignment.h>
+
+#include "RtedSymbols.h"
+#include "DataStructures.h"
+#include "RtedTransformation.h"
+
+namespace SI = SageInterface;
+namespace SB = SageBuilder;
+
+//
+// Removal of redundant checks (--RTED:eliminateRedundantChecks)
+//
+// The pass runs after the variable traversal and before any check is
+// inserted. It only shrinks the lists of collected checks, or moves
+// entries to array_range_checks.
+//
+// (1) a read check of a variable is redundant, when an identical check
+//     of the same variable is executed before, on every path within the
+//     same function invocation.
+//     A variable that was readable remains readable until it goes out
+//     of scope.
+// (2) identical array access checks within one statement
+// (3) the bounds checks of arr[i] in a counted loop
+//       for (i = lb; i < ub; ++i) { ... arr[i] = ...; ... }
+//     are replaced by checks of arr[lb] and arr[ub-1] before the loop
+//     (for non-empty iteration spaces).
+//     i must be a local variable without aliases that the body does
+//     not define, and arr and ub must be loop invariant.
+//     Only write accesses are considered, because reads also test
+//     the initialization status of each element.
+//
+
+typedef Rose_STL_Container<SgNode*>         NodeContainer;
+typedef StaticSingleAssignment::VarName     SsaVarName;
+typedef std::set<SsaVarName>                SsaVarSet;
+
+/// \brief tests whether e and its subexpressions can be evaluated repeatedly
+///        without changing the state of the program
+static
+bool isSideEffectFree(SgExpression& e)
+{
+  const NodeContainer nodes = NodeQuery::querySubTree(&e, V_SgExpression);
+
+  BOOST_FOREACH( SgNode* n, nodes )
+  {
+    if (  isSgFunctionCallExp(n)
+       || isSgAssignOp(n)
+       || isSgCompoundAssignOp(n)
+       || isSgPlusPlusOp(n)
+       || isSgMinusMinusOp(n)
+       || isSgNewExp(n)
+       || isSgDeleteExp(n)
+       || isSgThrowOp(n)
+       )
+      return false;
+  }
+
+  return true;
+}
+
+/// \brief tests whether accesses to var always refer to the same storage
+///        within one function invocation
+static
+bool hasFixedStorage(const SgInitializedName& var)
+{
+  SgType* const type = var.get_type();
+
+  return (  !isSgReferenceType(skip_Typedefs(type))
+         && !isStructMember(var)
+         && !isUpcShared(type)
+         );
+}
+
+/// \brief tests whether the blocks of fundef can only be entered at the top
+/// \note  case labels are handled by dominates
+static
+bool hasStructuredControlFlow(SgFunctionDefinition& fundef)
+{
+  return (  NodeQuery::querySubTree(&fundef, V_SgLabelStatement).empty()
+         && NodeQuery::querySubTree(&fundef, V_SgGotoStatement).empty()
+         );
+}
+
+/// \brief tests whether dom is executed before stmt, whenever stmt is executed
+/// \pre   the function does not contain labels
+static
+bool dominates(SgStatement& dom, SgStatement& stmt)
+{
+  SgBasicBlock* const block = isSgBasicBlock(dom.get_parent());
+  if (block == NULL) return false;
+
+  // blocks within a switch can be entered through case labels
+  for (SgNode* n = block; !isSgFunctionDefinition(n); n = n->get_parent())
+  {
+    if (n == NULL || isSgSwitchStatement(n)) return false;
+  }
+
+  // find the statement in block that contains stmt
+  SgNode* curr = &stmt;
+
+  while (curr->get_parent() != block)
+  {
+    curr = curr->get_parent();
+
+    // do not leave the function (e.g., member functions of local classes)
+    if (curr == NULL || isSgFunctionDefinition(curr)) return false;
+  }
+
+  // checks of the same statement are all inserted before it
+  if (curr == &dom) return &stmt == &dom;
+
+  const SgStatementPtrList&          stmts = block->get_statements();
+  SgStatementPtrList::const_iterator domPos = std::find(stmts.begin(), stmts.end(), &dom);
+
+  return std::find(domPos, stmts.end(), curr) != stmts.end();
+}
+
+/// \brief true, iff insertAccessVariable generates a check for varref
+///        directly before stmt
+bool RtedTransformation::isAccessChecked(SgVarRefExp& varref, SgStatement& stmt)
+{
+  SgDotExp* const parent_dot = isSgDotExp(varref.get_parent());
+
+  return (  !stmt.get_file_info()->isCompilerGenerated()
+         && isSgBasicBlock(stmt.get_parent())
+         && isInInstrumentedFile(varref.get_symbol()->get_declaration())
+         && !isFileIOVariable(varref.get_type())
+         && !(parent_dot && parent_dot->get_lhs_operand() == &varref)
+         );
+}
+
+void RtedTransformation::eliminateRedundantAccessChecks()
+{
+  typedef std::map<SgFunctionDefinition*, bool>                       StructureCache;
+  typedef std::map<SgInitializedName*, std::vector<SgStatement*> >    CheckLocations;
+
+  StructureCache            structured;
+  CheckLocations            checked;
+  std::vector<SgVarRefExp*> remaining;
+
+  BOOST_FOREACH( SgVarRefExp* vr, variable_access_varref )
+  {
+    SgInitializedName*    var = vr->get_symbol()->get_declaration();
+    SgStatement*          stmt = getSurroundingStatement(*vr);
+    SgFunctionDefinition* fundef = SI::getEnclosingFunctionDefinition(stmt);
+
+    if (fundef == NULL || !hasFixedStorage(*var))
+    {
+      remaining.push_back(vr);
+      continue;
+    }
+
+    StructureCache::iterator pos = structured.find(fundef);
+
+    if (pos == structured.end())
+      pos = structured.insert(std::make_pair(fundef, hasStructuredControlFlow(*fundef))).first;
+
+    std::vector<SgStatement*>&          locs = checked[var];
+    std::vector<SgStatement*>::iterator dom = locs.begin();
+
+    if (pos->second)
+    {
+      while (dom != locs.end() && !dominates(**dom, *stmt)) ++dom;
+    }
+    else
+    {
+      dom = locs.end();
+    }
+
+    if (dom != locs.end())
+    {
+      if (RTEDDEBUG) std::cerr << "   redundant access check: " << vr->unparseToString() << std::endl;
+      continue;
+    }
+
+    remaining.push_back(vr);
+    if (isAccessChecked(*vr, *stmt)) locs.push_back(stmt);
+  }
+
+  variable_access_varref.swap(remaining);
+}
+
+
+/// \brief tests whether lhs and rhs compute the same value, when evaluated
+///        at the same program point
+static
+bool isSameExpression(SgExpression& lhs, SgExpression& rhs)
+{
+  if (lhs.unparseToString() != rhs.unparseToString()) return false;
+
+  // the same names could refer to different declarations
+  const NodeContainer lhsrefs = NodeQuery::querySubTree(&lhs, V_SgVarRefExp);
+  const NodeContainer rhsrefs = NodeQuery::querySubTree(&rhs, V_SgVarRefExp);
+
+  if (lhsrefs.size() != rhsrefs.size()) return false;
+
+  for (size_t i = 0; i < lhsrefs.size(); ++i)
+  {
+    if (isSgVarRefExp(lhsrefs[i])->get_symbol() != isSgVarRefExp(rhsrefs[i])->get_symbol())
+      return false;
+  }
+
+  return true;
+}
+
+void RtedTransformation::eliminateRedundantArrayChecks()
+{
+  typedef std::map<SgPntrArrRefExp*, RtedArray>               ArrayAccesses;
+  typedef std::map<SgStatement*, std::vector<SgPntrArrRefExp*> > AccessesByStatement;
+
+  AccessesByStatement                 bystmt;
+  std::vector<SgPntrArrRefExp*>       redundant;
+
+  // checks of the same statement are inserted at the same location
+  for (ArrayAccesses::iterator it = create_array_access_call.begin(); it != create_array_access_call.end(); ++it)
+  {
+    if (isSideEffectFree(*it->first)) bystmt[it->second.getStmt()].push_back(it->first);
+  }
+
+  BOOST_FOREACH( AccessesByStatement::value_type& entry, bystmt )
+  {
+    std::vector<SgPntrArrRefExp*>& accesses = entry.second;
+
+    for (size_t i = 0; i < accesses.size(); ++i)
+    {
+      const int mask = read_write_context(accesses[i]);
+
+      // redundant, if another check tests the same element with at least the same flags
+      for (size_t j = 0; j < accesses.size(); ++j)
+      {
+        if (i == j || accesses[j] == NULL) continue;
+
+        const int other = read_write_context(accesses[j]);
+
+        if (  (mask & other) == mask
+           && (mask != other || j < i)
+           && isSameExpression(*accesses[i], *accesses[j])
+           )
+        {
+          redundant.push_back(accesses[i]);
+          accesses[i] = NULL;
+          break;
+        }
+      }
+    }
+  }
+
+  BOOST_FOREACH( SgPntrArrRefExp* arrexp, redundant )
+  {
+    if (RTEDDEBUG) std::cerr << "   redundant array check: " << arrexp->unparseToString() << std::endl;
+
+    create_array_access_call.erase(arrexp);
+  }
+}
+
+
+/// \brief tests whether e is evaluated whenever stmt is executed
+static
+bool isUnconditionallyEvaluated(SgExpression& e, SgStatement& stmt)
+{
+  SgNode* child = &e;
+  SgNode* parent = e.get_parent();
+
+  while (parent != &stmt)
+  {
+    SgConditionalExp* condexp = isSgConditionalExp(parent);
+    SgBinaryOp*       shortcut = (isSgAndOp(parent) || isSgOrOp(parent)) ? isSgBinaryOp(parent) : NULL;
+
+    if (condexp && condexp->get_conditional_exp() != child) return false;
+    if (shortcut && shortcut->get_rhs_operand() == child) return false;
+
+    child = parent;
+    parent = parent->get_parent();
+  }
+
+  return true;
+}
+
+/// \brief returns the loop (or switch) that is exited by a break or continue
+static
+SgStatement* jumpTarget(SgStatement& jmp)
+{
+  const bool breakstmt = isSgBreakStmt(&jmp);
+  SgNode*    n = jmp.get_parent();
+
+  while (  !isSgForStatement(n) && !isSgWhileStmt(n) && !isSgDoWhileStmt(n)
+        && !(breakstmt && isSgSwitchStatement(n))
+        )
+  {
+    n = n->get_parent();
+  }
+
+  return isSgStatement(n);
+}
+
+/// \brief tests whether each iteration of loop executes its entire body
+/// \details function calls could call exit, longjmp, or throw
+static
+bool completesAllIterations(SgForStatement& loop)
+{
+  const NodeContainer nodes = NodeQuery::querySubTree(loop.get_loop_body(), V_SgLocatedNode);
+
+  BOOST_FOREACH( SgNode* n, nodes )
+  {
+    switch (n->variantT())
+    {
+      case V_SgBreakStmt:
+      case V_SgContinueStmt:
+        if (jumpTarget(*isSgStatement(n)) == &loop) return false;
+        break;
+
+      case V_SgReturnStmt:
+      case V_SgGotoStatement:
+      case V_SgLabelStatement:
+      case V_SgFunctionCallExp:
+      case V_SgConstructorInitializer:
+      case V_SgNewExp:
+      case V_SgDeleteExp:
+      case V_SgThrowOp:
+        return false;
+
+      default: ;
+    }
+  }
+
+  return true;
+}
+
+/// \brief tests whether var can only be modified by name, within fundef
+static
+bool isPrivateVariable(SgInitializedName& var, SgFunctionDefinition& fundef)
+{
+  SgScopeStatement* const scope = var.get_scope();
+
+  if (scope == NULL || !(scope == &fundef || SI::isAncestor(&fundef, scope)))
+    return false;
+
+  if (!hasFixedStorage(var)) return false;
+
+  SgVariableDeclaration* const decl = isSgVariableDeclaration(var.get_declaration());
+
+  if (decl && decl->get_declarationModifier().get_storageModifier().isStatic())
+    return false;
+
+  // no aliases: the address is not taken, and no reference is bound to var
+  const NodeContainer varrefs = NodeQuery::querySubTree(&fundef, V_SgVarRefExp);
+
+  BOOST_FOREACH( SgNode* n, varrefs )
+  {
+    SgVarRefExp* varref = isSgVarRefExp(n);
+    if (varref->get_symbol()->get_declaration() != &var) continue;
+
+    SgNode* parent = varref->get_parent();
+    while (isSgCastExp(parent)) parent = parent->get_parent();
+
+    if (isSgAddressOfOp(parent)) return false;
+
+    // C++ reference parameters
+    if (isSgExprListExp(parent) && SI::is_Cxx_language()) return false;
+
+    SgInitializedName* bound = isSgAssignInitializer(parent) ? isSgInitializedName(parent->get_parent()) : NULL;
+
+    if (bound && isSgReferenceType(skip_Typedefs(bound->get_type()))) return false;
+  }
+
+  return true;
+}
+
+/// \brief tests whether e evaluates to the same value before and in every iteration of loop
+static
+bool isLoopInvariant(SgExpression& e, SgFunctionDefinition& fundef, const SsaVarSet& loopdefs)
+{
+  if (!isSideEffectFree(e)) return false;
+
+  const NodeContainer nodes = NodeQuery::querySubTree(&e, V_SgExpression);
+
+  BOOST_FOREACH( SgNode* n, nodes )
+  {
+    // memory could be written through aliases
+    if (isSgPointerDerefExp(n) || isSgArrowExp(n) || isSgDotExp(n) || isSgPntrArrRefExp(n))
+      return false;
+
+    SgVarRefExp* varref = isSgVarRefExp(n);
+    if (varref == NULL) continue;
+
+    SgInitializedName& var = *varref->get_symbol()->get_declaration();
+
+    if (!isPrivateVariable(var, fundef) || loopdefs.count(SsaVarName(1, &var)))
+      return false;
+  }
+
+  return true;
+}
+
+/// \brief tests whether arr refers to the same memory block in every iteration
+static
+bool isLoopInvariantArray(SgVarRefExp& arr, SgFunctionDefinition& fundef, const SsaVarSet& loopdefs)
+{
+  SgInitializedName& var = *arr.get_symbol()->get_declaration();
+  SgType*            type = skip_Typedefs(var.get_type());
+
+  // the storage of arrays does not change during their lifetime
+  //   (array parameters are pointers)
+  if (isSgArrayType(type)) return !isFunctionParameter(var) && hasFixedStorage(var);
+
+  return isSgPointerType(type) && isLoopInvariant(arr, fundef, loopdefs);
+}
+
+
+/// \brief a write access arr[i] in the body of a counted loop
+struct LoopAccess
+{
+  SgPntrArrRefExp*   access;
+  SgStatement*       stmt;
+  SgForStatement*    loop;
+  SgExpression*      lb;
+  SgExpression*      ub;
+  SgInitializedName* ivar;
+  bool               inclusive;
+};
+
+/// \brief tests whether the only check of access is a bounds check
+///        in a loop for (i = lb; i < ub; ++i) that executes stmt in every iteration.
+static
+bool matchLoopAccess(SgPntrArrRefExp& access, SgStatement& stmt, LoopAccess& res)
+{
+  if (read_write_context(&access) != RtedTransformation::BoundsCheck) return false;
+
+  SgVarRefExp* const arr = isSgVarRefExp(access.get_lhs_operand());
+  SgVarRefExp* const idx = isSgVarRefExp(SI::SkipCasting(access.get_rhs_operand()));
+
+  if (arr == NULL || idx == NULL || !isUnconditionallyEvaluated(access, stmt)) return false;
+
+  SgBasicBlock* const   body = isSgBasicBlock(stmt.get_parent());
+  SgForStatement* const loop = body ? isSgForStatement(body->get_parent()) : NULL;
+
+  if (loop == NULL || loop->get_loop_body() != body || !isSgBasicBlock(loop->get_parent()))
+    return false;
+
+  SgInitializedName* ivar = NULL;
+  SgExpression*      lb = NULL;
+  SgExpression*      ub = NULL;
+  bool               incremental = false;
+  bool               inclusive = false;
+
+  if (!SI::isCanonicalForLoop(loop, &ivar, &lb, &ub, NULL, NULL, &incremental, &inclusive))
+    return false;
+
+  if (  !incremental
+     || !isSgPlusPlusOp(loop->get_increment())
+     || idx->get_symbol() != ivar->get_symbol_from_symbol_table()
+     || !isSideEffectFree(*lb)
+     || !completesAllIterations(*loop)
+     )
+    return false;
+
+  res.access = &access;
+  res.stmt = &stmt;
+  res.loop = loop;
+  res.lb = lb;
+  res.ub = ub;
+  res.ivar = ivar;
+  res.inclusive = inclusive;
+  return true;
+}
+
+void RtedTransformation::hoistArrayChecksFromLoops(SgProject* project)
+{
+  typedef std::map<SgPntrArrRefExp*, RtedArray>                    ArrayAccesses;
+  typedef std::pair<SgForStatement*, SgInitializedName*>           LoopArray;
+
+  std::vector<LoopAccess> candidates;
+
+  for (ArrayAccesses::iterator it = create_array_access_call.begin(); it != create_array_access_call.end(); ++it)
+  {
+    LoopAccess la;
+
+    if (matchLoopAccess(*it->first, *it->second.getStmt(), la)) candidates.push_back(la);
+  }
+
+  if (candidates.empty()) return;
+
+  // only direct definitions are needed, aliases are ruled out by isPrivateVariable
+  StaticSingleAssignment ssa(project);
+
+  ssa.run(false /* interprocedural */, false /* treatPointersAsStructures */);
+
+  std::set<LoopArray> hoisted;
+
+  BOOST_FOREACH( const LoopAccess& la, candidates )
+  {
+    SgFunctionDefinition* fundef = SI::getEnclosingFunctionDefinition(la.loop);
+    SgVarRefExp*          arr = isSgVarRefExp(la.access->get_lhs_operand());
+    const SsaVarSet       loopdefs = ssa.getVarsDefinedInSubtree(la.loop);
+    const SsaVarSet       bodydefs = ssa.getVarsDefinedInSubtree(la.loop->get_loop_body());
+
+    // the body must not change the loop variable, directly or through an alias
+    if (  fundef == NULL
+       || !isPrivateVariable(*la.ivar, *fundef)
+       || bodydefs.count(SsaVarName(1, la.ivar))
+       || isUpcShared(arr->get_type())
+       || !isLoopInvariantArray(*arr, *fundef, loopdefs)
+       || !isLoopInvariant(*la.ub, *fundef, loopdefs)
+       )
+      continue;
+
+    if (RTEDDEBUG) std::cerr << "   array check hoisted from loop: " << la.access->unparseToString() << std::endl;
+
+    create_array_access_call.erase(la.access);
+
+    const LoopArray key(la.loop, arr->get_symbol()->get_declaration());
+
+    if (!hoisted.insert(key).second) continue;
+
+    // the loop variable is initialized with lb converted to its type
+    SgExpression* lb = SB::buildCastExp(SI::deepCopy(la.lb), la.ivar->get_type());
+
+    array_range_checks.push_back( RtedArrayRange( la.loop,
+                                                  la.stmt,
+                                                  SI::deepCopy(arr),
+                                                  lb,
+                                                  SI::deepCopy(la.ub),
+                                                  la.inclusive
+                                                ) );
+  }
+}
+
+
+void RtedTransformation::eliminateRedundantChecks(SgProject* project)
+{
+  if (RTEDDEBUG) std::cerr << "Eliminating redundant checks..." << std::endl;
+
+  eliminateRedundantAccessChecks();
+  hoistArrayChecksFromLoops(project);
+  eliminateRedundantArrayChecks();
+}
+
+
+/* -----------------------------------------------------------
+ * Perform Transformation: insertArrayRangeCheck
+ *
+ *   if (lb < ub) { check(arr[lb]); check(arr[ub-1]); }
+ *   for (i = lb; i < ub; ++i) { ... arr[i] = ...; ... }
+ * -----------------------------------------------------------*/
+void RtedTransformation::insertArrayRangeCheck(const RtedArrayRange& range)
+{
+  SgExpression* last = NULL;
+  SgExpression* nonempty = NULL;
+
+  if (range.inclusive)
+  {
+    last = SI::deepCopy(range.ub);
+    nonempty = SB::buildLessOrEqualOp(SI::deepCopy(range.lb), SI::deepCopy(range.ub));
+  }
+  else
+  {
+    last = SB::buildSubtractOp(SI::deepCopy(range.ub), SB::buildIntVal(1));
+    nonempty = SB::buildLessThanOp(SI::deepCopy(range.lb), SI::deepCopy(range.ub));
+  }
+
+  SgBasicBlock* const checks = SB::buildBasicBlock();
+  SgExpression* const bounds[] = { range.lb, last };
+
+  BOOST_FOREACH( SgExpression* idx, bounds )
+  {
+    SgPntrArrRefExp*   elem = SB::buildPntrArrRefExp(SI::deepCopy(range.array), idx);
+    SgExprListExp*     arg_list = buildArrayAccessArgs(range.stmt, elem, BoundsCheck);
+    SgFunctionCallExp* callexp = SB::buildFunctionCallExp(SB::buildFunctionRefExp(symbols.roseAccessArray), arg_list);
+
+    SI::appendStatement(SB::buildExprStatement(callexp), checks);
+  }
+
+  SgIfStmt* const guard = SB::buildIfStmt(nonempty, checks, NULL);
+
+  SI::insertStatementBefore(range.loop, guard);
+  SI::attachComment(guard, "", PreprocessingInfo::before);
+  SI::attachComment(guard, "RS : Access Array Range, checks the bounds of the first and last element accessed by the loop", PreprocessingInfo::before);
+}
+
+#endif
@@ -53,6 +53,9 @@ void RtedTransformation::transform(SgProject* project)
    // Call the traversal starting at the project (root) node of the AST
    varTraversal.traverseInputFiles(project, InheritedAttribute());
 
+   // prune the collected checks, while the AST is still unmodified
+   if (options.eliminateRedundantChecks) eliminateRedundantChecks(project);
+
    // tps: Traverse all classes that appear in header files and create copy in
    // source file within a namespace We need to know the sizeOf classes. To do
    // so we need to modify the class but do not want to do this in the header
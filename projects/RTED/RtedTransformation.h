@@ -24,6 +24,7 @@ typedef std::set<std::string> RtedFiles;
 struct RtedOptions
 {
   bool globalsInitialized;
+  bool eliminateRedundantChecks;
 };
 
 
@@ -113,6 +114,10 @@ bool isFunctionParameter(const SgInitializedName& n);
 /// \brief true, iff n is a basic block, if statement, [do]while, or for statement
 bool isNormalScope( SgScopeStatement* n );
 
+/// \brief  determines how an array element is accessed
+/// \return a combination of RtedTransformation::ReadWriteMask flags
+int read_write_context(const SgExpression* node);
+
 /// \brief tests whether the statement defines a global external variable
 ///        OR a function parameter of a function declared extern (\pp ???)
 bool isGlobalExternVariable(SgStatement* stmt);
@@ -313,6 +318,7 @@ private:
 
    std::map<SgVarRefExp*, RtedArray>        create_array_define_varRef_multiArray; ///< The array of callArray calls that need to be inserted
    std::map<SgPntrArrRefExp*, RtedArray>    create_array_access_call;
+   std::vector<RtedArrayRange>              array_range_checks;    ///< bounds checks hoisted out of loops
    std::vector<SgVarRefExp*>                variablesUsedForArray; ///< remember variables that were used to create an
                                                                    ///  array. These cant be reused for array usage calls
 
@@ -522,6 +528,8 @@ public:
 
    void insertArrayAccessCall(SgPntrArrRefExp* arrayExp, const RtedArray& value);
    void insertArrayAccessCall(SgStatement* stmt, SgPntrArrRefExp* arrayExp, const RtedArray& array);
+   SgExprListExp* buildArrayAccessArgs(SgStatement* stmt, SgPntrArrRefExp* arrayExp, int read_write_mask);
+   void insertArrayRangeCheck(const RtedArrayRange& range);
 
    //~ bool isVarRefInCreateArray(SgInitializedName* search);
    void insertFuncCall(RtedArguments& args);
@@ -605,6 +613,7 @@ public:
      rtedfiles(prjfiles),
      create_array_define_varRef_multiArray(),
      create_array_access_call(),
+     array_range_checks(),
      variablesUsedForArray(),
      sharedptr_derefs(),
      unusedReturnValue(),
@@ -691,6 +700,14 @@ public:
    void visit_isClassDefinition(SgClassDefinition* const cdef);
 
    void executeTransformations();
+
+   /// \brief removes checks that are implied by other checks
+   ///        (see RtedTransf_redundantChecks.cpp)
+   void eliminateRedundantChecks(SgProject* project);
+   void eliminateRedundantAccessChecks();
+   void eliminateRedundantArrayChecks();
+   void hoistArrayChecksFromLoops(SgProject* project);
+   bool isAccessChecked(SgVarRefExp& varref, SgStatement& stmt);
    void insertNamespaceIntoSourceFile(SgSourceFile* sf);
    void insertNamespaceIntoSourceFile(SgProject* project);
    // void insertNamespaceIntoSourceFile(SgProject* project, std::vector<SgClassDeclaration*>&);
@@ -7,6 +7,9 @@
 
 #include <string>
 #include <set>
+#include <vector>
+#include <algorithm>
+#include <iterator>
 #include <iostream>
 /* driscoll6 (4/15/11) The default Boost::Filesystem version was
  * bumped from 2 to 3 in Boost 1.46. Use version 2 until we have time to
@@ -42,6 +45,10 @@ extern char const globalsInitOption[] = "globalsInitialized";
 extern char const globalsInitHelp[]   = "sets the initializtion status of globals to true\n"
                                         "                    this is standard behavior in C/C99/UPC";
 
+extern char const redundantChecksOption[] = "eliminateRedundantChecks";
+extern char const redundantChecksHelp[]   = "omits checks that are implied by earlier checks, and\n"
+                                            "                    checks the array bounds of simple counted loops once";
+
 
 void
 runtimeCheck(int argc, char** argv, const RtedFiles& rtedfiles, RtedOptions ropt)
@@ -82,6 +89,14 @@ bool notAFile(const char* arg)
   return !boostfs::exists(arg);
 }
 
+static const std::string rtedOptionPrefix("--RTED:");
+
+static inline
+bool isRtedOption(const char* arg)
+{
+  return boost::starts_with(arg, rtedOptionPrefix);
+}
+
 struct FileRegistrar
 {
   std::set<std::string> filenames;
@@ -100,20 +115,20 @@ struct FileRegistrar
 
 struct OptionsRegistrar
 {
-  RtedBooleanOption<bool, false, globalsInitOption, globalsInitHelp> globalsInitialized;
+  RtedBooleanOption<bool, false, globalsInitOption, globalsInitHelp>         globalsInitialized;
+  RtedBooleanOption<bool, false, redundantChecksOption, redundantChecksHelp> eliminateRedundantChecks;
 
   void set_option(const std::string& optname)
   {
     if (optname == globalsInitialized.name) globalsInitialized.set();
+    if (optname == eliminateRedundantChecks.name) eliminateRedundantChecks.set();
   }
 
   void operator()(const char* opt)
   {
-    static const std::string opt_prefix("--RTED:");
-
-    if (!boost::starts_with(opt, opt_prefix)) return;
+    if (!isRtedOption(opt)) return;
 
-    set_option(opt + opt_prefix.length());
+    set_option(opt + rtedOptionPrefix.length());
   }
 
   operator RtedOptions() const
@@ -121,6 +136,7 @@ struct OptionsRegistrar
     RtedOptions res;
 
     res.globalsInitialized = globalsInitialized;
+    res.eliminateRedundantChecks = eliminateRedundantChecks;
 
     return res;
   }
@@ -132,6 +148,8 @@ struct OptionsRegistrar
 std::ostream& operator<<(std::ostream& os, const OptionsRegistrar& opt)
 {
   os << opt.globalsInitialized.name << opt.globalsInitialized.help
+     << std::endl
+     << opt.eliminateRedundantChecks.name << opt.eliminateRedundantChecks.help
      << std::endl;
 }
 
@@ -166,7 +184,13 @@ int main(int argc, char** argv)
       std::cout << i << " : " << argv[i] << std::endl;
    }
 
-   runtimeCheck(argc, argv, rtedFiles, rtedOptions);
+   // the frontend would pass the RTED options on to the backend compiler
+   std::vector<char*>    roseArgs;
+
+   std::remove_copy_if( argv, limitopt, std::back_inserter(roseArgs), isRtedOption );
+   roseArgs.push_back(NULL);
+
+   runtimeCheck(roseArgs.size()-1, &roseArgs[0], rtedFiles, rtedOptions);
    return 0;
 }
 #endif
@@ -0,0 +1,19 @@
+
+int main() {
+
+   int arr[ 10 ];
+   int i;
+   int x = 1;
+   int z;
+
+   // the second check of x is redundant
+   z = x;
+   z = x;
+
+   // the bounds checks of arr[i] are replaced by one range check before the loop
+   for (i = 0; i < 10; ++i) {
+      arr[ i ] = i;
+   }
+
+   return z - 1;
+}
@@ -0,0 +1,15 @@
+
+int main() {
+
+   int arr[ 10 ];
+   int i;
+
+   // the body changes i, so arr[i] is not limited to arr[0] .. arr[9]
+   // and must be checked in every iteration (i = 14 in the fourth)
+   for (i = 0; i < 10; ++i) {
+      i = i * 2;
+      arr[ i ] = i;
+   }
+
+   return 0;
+}
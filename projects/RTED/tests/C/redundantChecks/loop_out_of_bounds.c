@@ -0,0 +1,14 @@
+
+int main() {
+
+   int arr[ 10 ];
+   int i;
+
+   // the bounds checks of arr[i] are hoisted out of the loop,
+   // the check of the last element must still fail
+   for (i = 0; i <= 10; ++i) {
+      arr[ i ] = i;
+   }
+
+   return 0;
+}
@@ -0,0 +1,14 @@
+
+int main() {
+
+   int x = 1;
+   int y;
+   int z;
+
+   z = x;
+
+   // the check of x is redundant, but y is read before it is initialized
+   z = x + y;
+
+   return z;
+}
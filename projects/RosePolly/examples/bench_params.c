@@ -0,0 +1,30 @@
+/*
+ *  Problem sizes of the example programs, used by the benchmark script.
+ *	Each call to bar(), bar1() or bar2() returns the next entry of the
+ *	comma separated list in $ROSE_POLLY_BENCH_SIZES (500 when it runs out).
+ */
+
+#include <stdlib.h>
+
+static const char * sizes = NULL;
+
+static int next_size()
+{
+	char * end;
+	long value;
+	
+	if ( sizes == NULL )
+		sizes = getenv("ROSE_POLLY_BENCH_SIZES");
+	if ( sizes == NULL || *sizes == '\0' )
+		return 500;
+	
+	value = strtol(sizes,&end,10);
+	sizes = ( *end == ',' ) ? end+1 : end;
+	return ( value > 0 ) ? (int)value : 500;
+}
+
+int bar() { return next_size(); }
+
+int bar1() { return next_size(); }
+
+int bar2() { return next_size(); }
@@ -122,6 +122,7 @@ public:
 	void push_loop_type( loop_type t );
 	
 	int get_ID() const;
+	loop_type get_loop_type( int level ) const;
 	SgExprStatement * get_statement() const;
 	AccessPattern * get_read( int pos ) const;
 	AccessPattern * get_write( int pos ) const;
@@ -2,6 +2,26 @@
 #ifndef SG_CLOOG_H
 #define SG_CLOOG_H
 
+/*
+ *	Options of the code generated by RoseCloog::generate_code()
+ */
+struct polly_codegen_options {
+	
+	bool tile;				// tile the permutable bands that span two loops or more
+	int tile_size;			// default tile size, see rosepoly/RosePollyRuntime.h
+	bool parallel;			// omp parallel for on the outermost parallel loop, or on a wavefront of tiles
+	bool vectorize;			// put vector_pragma on the innermost parallel loops
+	string vector_pragma;
+	
+	polly_codegen_options();
+};
+
+/*
+ *	Range of the iterator of each enclosing tile. A loop bound expanded over
+ *	these ranges bounds the loop for all the points of the tiles.
+ */
+typedef map<string,pair<SgExpression*,SgExpression*> > clast_ranges;
+
 class RoseCloog : public RosePollyModel {
 	
 	CloogState * state;
@@ -11,18 +31,44 @@ class RoseCloog : public RosePollyModel {
 	
 	struct clast_stmt * ast;
 	
+	/* code generation state */
+	polly_codegen_options gen_opts;
+	SgBasicBlock * gen_block;
+	set<string> gen_vars;
+	set<string> gen_iterators;
+	bool gen_in_parallel;
+	bool gen_tiled;
+	
 	Statement * unparse_clast_stmt( struct clast_user_stmt * s ) const;
 	ForLoop * unparse_clast_for( struct clast_for * f ) const;
-	SgExpression * unparse_clast_expr( struct clast_expr * e ) const;
+	SgExpression * unparse_clast_expr( struct clast_expr * e, const clast_ranges * r = NULL, bool lower = true ) const;
 	SgVarRefExp * unparse_clast_expr_name( struct clast_name * n ) const;
-	SgExpression * unparse_clast_expr_term( struct clast_term * t ) const;
-	SgExpression * unparse_clast_expr_red( struct clast_reduction * r ) const;
+	SgExpression * unparse_clast_expr_term( struct clast_term * t, const clast_ranges * r = NULL, bool lower = true ) const;
+	SgExpression * unparse_clast_expr_red( struct clast_reduction * r, const clast_ranges * rg = NULL, bool lower = true ) const;
+	SgExpression * unparse_clast_expr_bin( struct clast_binary * b, const clast_ranges * r = NULL, bool lower = true ) const;
 	SgIntVal * unparse_clast_integer( cloog_int_t i ) const;
-	SgExpression * unparse_clast_sum( struct clast_reduction * r ) const;
+	SgExpression * unparse_clast_sum( struct clast_reduction * r, const clast_ranges * rg = NULL, bool lower = true ) const;
+	bool can_bound_clast_expr( struct clast_expr * e ) const;
 	
 	CloogDomain * get_param_context() const;
 	FlowGraph * unparse_clast( struct clast_stmt * s ) const;
 	
+	int get_loop_dim( struct clast_for * f ) const;
+	int get_loop_level( int dim ) const;
+	loop_type get_loop_type( struct clast_stmt * s, int dim ) const;
+	bool is_innermost( struct clast_stmt * s ) const;
+	
+	SgVarRefExp * declare_variable( const string& name, SgExpression * init = NULL );
+	SgVarRefExp * declare_iterator( const string& name );
+	SgVarRefExp * declare_tile_size( int dim );
+	void append_loop( SgBasicBlock * block, SgForStatement * loop, bool parallel, bool vector );
+	
+	void generate_clast( struct clast_stmt * s, SgBasicBlock * block );
+	SgStatement * generate_user_stmt( struct clast_user_stmt * u ) const;
+	void generate_guard( struct clast_guard * g, SgBasicBlock * block );
+	void generate_for( struct clast_for * f, SgBasicBlock * block );
+	bool generate_tiled_band( struct clast_for * f, SgBasicBlock * block );
+	
 public:
 	
 	RoseCloog( const RosePollyModel& model );
@@ -38,6 +84,9 @@ public:
 	
 	void apply( CloogOptions * opts );
 	
+	/* Replaces the kernel block with the code of the clast. */
+	void generate_code( SgBasicBlock * kernel, const polly_codegen_options& o );
+	
 	virtual void print( int ident ) const;
 	
 	~RoseCloog();
@@ -39,6 +39,9 @@ RosePluto * RosePollyBuildPluto( RosePollyModel * model );
 
 RoseCloog * RosePollyBuildCloog( RosePollyModel * model );
 
+/* Replaces the kernel of the model with the code generated by CLooG */
+void RosePollyGenerateCode( RoseCloog * cloog, const polly_codegen_options& opts = polly_codegen_options() );
+
 void RosePollyTerminate();
 
 
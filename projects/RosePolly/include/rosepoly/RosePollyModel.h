@@ -151,6 +151,9 @@ protected:
 	symbol_table data;
 	int ID;
 	
+	/* permutable band of each dimension of the transformation, -1 for the scalar ones */
+	vector<int> bands;
+	
 	simple_multi_graph * ddg;
 		
 	void ddg_create();
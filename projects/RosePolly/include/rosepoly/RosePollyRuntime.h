@@ -0,0 +1,33 @@
+
+/*
+ *  Run time support of the code generated by RoseCloog::generate_code().
+ *	The generated code includes this header when it has tiles.
+ *
+ *	rose_polly_tile_size(level,size) returns the tile size of the loops at
+ *	the given level (counting from 1) of the transformed loop nest: the
+ *	level-th entry of the comma separated list in $ROSE_POLLY_TILE_SIZES
+ *	when it is positive, and size otherwise. For instance,
+ *	ROSE_POLLY_TILE_SIZES=64,64,8 sets the sizes of the first three levels.
+ */
+
+#ifndef ROSE_POLLY_RUNTIME_H
+#define ROSE_POLLY_RUNTIME_H
+
+#include <stdlib.h>
+
+static int rose_polly_tile_size( int level, int size )
+{
+	const char * s = getenv("ROSE_POLLY_TILE_SIZES");
+	int i;
+	
+	for ( i = 1 ; s != NULL && *s != '\0' ; i++ ) {
+		char * end;
+		long value = strtol(s,&end,10);
+		if ( i == level )
+			return ( end != s && value > 0 ) ? (int)value : size;
+		s = ( *end == ',' ) ? end+1 : NULL;
+	}
+	return size;
+}
+
+#endif
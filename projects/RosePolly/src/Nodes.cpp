@@ -115,6 +115,11 @@ void Statement::push_loop_type( loop_type t ) { l_types.push_back(t); }
 
 int Statement::get_ID() const { return ID; }
 
+loop_type Statement::get_loop_type( int level ) const
+{
+	return ( level >= 0 && level < l_types.size() ) ? l_types[level] : UNDEFINED;
+}
+
 AccessPattern * Statement::get_read( int pos ) const { return Reads[pos]; }
 
 AccessPattern * Statement::get_write( int pos ) const { return Writes[pos]; }
@@ -9,6 +9,7 @@ using namespace std;
 #include <rosepoly/simple_matrix.h>
 
 using namespace SageBuilder;
+using namespace SageInterface;
 
 string charToString( const char * c )
 {
@@ -23,11 +24,54 @@ string charToString( const char * c )
 	return outS;
 }
 
+static SgExpression * build_min( SgExpression * a, SgExpression * b )
+{
+	return buildConditionalExp( buildLessThanOp(a,b), deepCopy(a), deepCopy(b) );
+}
+
+static SgExpression * build_max( SgExpression * a, SgExpression * b )
+{
+	return buildConditionalExp( buildGreaterThanOp(a,b), deepCopy(a), deepCopy(b) );
+}
+
+/* floor(a/b) and ceil(a/b) for b > 0, C division truncates towards zero */
+static SgExpression * build_floord( SgExpression * a, SgExpression * b )
+{
+	SgExpression * neg = buildAddOp( buildMinusOp(deepCopy(a)), buildSubtractOp(deepCopy(b),buildIntVal(1)) );
+	return buildConditionalExp( buildLessThanOp(a,buildIntVal(0)),
+							   buildMinusOp(buildDivideOp(neg,deepCopy(b))),
+							   buildDivideOp(deepCopy(a),b) );
+}
+
+static SgExpression * build_ceild( SgExpression * a, SgExpression * b )
+{
+	SgExpression * pos = buildAddOp( deepCopy(a), buildSubtractOp(deepCopy(b),buildIntVal(1)) );
+	return buildConditionalExp( buildGreaterThanOp(a,buildIntVal(0)),
+							   buildDivideOp(pos,deepCopy(b)),
+							   buildMinusOp(buildDivideOp(buildMinusOp(deepCopy(a)),b)) );
+}
+
+static SgForStatement * build_for( SgVarRefExp * it, SgExpression * lb, SgExpression * ub, 
+								  SgExpression * step, SgBasicBlock * body )
+{
+	SgStatement * init = buildAssignStatement(it,lb);
+	SgStatement * test = buildExprStatement( buildLessOrEqualOp(deepCopy(it),ub) );
+	SgExpression * incr = step ? (SgExpression*)buildPlusAssignOp(deepCopy(it),step) : 
+								 (SgExpression*)buildPlusPlusOp(deepCopy(it),SgUnaryOp::postfix);
+	return buildForStatement(init,test,incr,body);
+}
+
+// CODEGEN OPTIONS
+
+polly_codegen_options::polly_codegen_options()
+: tile(true), tile_size(32), parallel(true), vectorize(true), vector_pragma("omp simd") {}
+
 // CLOOG
 
 RoseCloog::RoseCloog( const RosePollyModel& model )
 : RosePollyModel(model), state(cloog_state_malloc()), 
-cloog_graph(NULL), ast(NULL), opts(NULL)
+cloog_graph(NULL), ast(NULL), opts(NULL), gen_block(NULL), 
+gen_in_parallel(false), gen_tiled(false)
 {
 	free_polly_context( state->backend->ctx );
 	state->backend->ctx = RosePollyBase::context;
@@ -181,32 +225,71 @@ ForLoop * RoseCloog::unparse_clast_for( struct clast_for * f ) const
 	return loop;
 }
 
-SgExpression * RoseCloog::unparse_clast_expr( struct clast_expr * e ) const
+/*
+ *	With ranges, the names found in r are replaced by the lower (or upper) end
+ *	of their range, so that the result is a lower (or upper) bound of e over
+ *	the ranges. NULL is returned when e cannot be bounded that way.
+ */
+SgExpression * RoseCloog::unparse_clast_expr( struct clast_expr * e, const clast_ranges * r, bool lower ) const
 {
 	if (!e)
 		return NULL;
 	
 	switch (e->type) {
 		case clast_expr_name:
+			if ( r != NULL ) {
+				clast_ranges::const_iterator it = r->find( ((struct clast_name*)e)->name );
+				if ( it != r->end() )
+					return deepCopy( lower ? it->second.first : it->second.second );
+			}
 			return unparse_clast_expr_name( (struct clast_name*)e );
 		case clast_expr_term:
-			return unparse_clast_expr_term( (struct clast_term*)e );
+			return unparse_clast_expr_term( (struct clast_term*)e, r, lower );
 		case clast_expr_red:
-			return unparse_clast_expr_red( (struct clast_reduction*)e );
+			return unparse_clast_expr_red( (struct clast_reduction*)e, r, lower );
 		case clast_expr_bin:
-			return NULL;
+			return unparse_clast_expr_bin( (struct clast_binary*)e, r, lower );
 		default:
 			assert(0);
 	}
 	return NULL;
 }
 
+/*
+ *	True iff unparse_clast_expr(e,r,lower) can bound e over ranges, i.e. does not return NULL.
+ */
+bool RoseCloog::can_bound_clast_expr( struct clast_expr * e ) const
+{
+	if (!e)
+		return false;
+	
+	switch (e->type) {
+		case clast_expr_name:
+			return true;
+		case clast_expr_term:
+			return !((struct clast_term*)e)->var || can_bound_clast_expr( ((struct clast_term*)e)->var );
+		case clast_expr_red:
+			for ( int i = 0 ; i < ((struct clast_reduction*)e)->n ; i++ )
+				if ( !can_bound_clast_expr( ((struct clast_reduction*)e)->elts[i] ) )
+					return false;
+			return true;
+		case clast_expr_bin:
+			return ((struct clast_binary*)e)->type != clast_bin_mod && can_bound_clast_expr( ((struct clast_binary*)e)->LHS );
+		default:
+			assert(0);
+	}
+	return false;
+}
+
 SgVarRefExp * RoseCloog::unparse_clast_expr_name( struct clast_name * n ) const
 {
+	if ( gen_block )
+		return buildVarRefExp(n->name, gen_block);
+	
 	return buildVarRefExp(n->name, GlobalScope);
 }
 
-SgExpression * RoseCloog::unparse_clast_expr_term( struct clast_term * t ) const
+SgExpression * RoseCloog::unparse_clast_expr_term( struct clast_term * t, const clast_ranges * r, bool lower ) const
 {
 	SgExpression * temp;
 	if (t->var) {
@@ -215,7 +298,10 @@ SgExpression * RoseCloog::unparse_clast_expr_term( struct clast_term * t ) const
 		int group = t->var->type == clast_expr_red &&
 		((struct clast_reduction*) t->var)->n > 1;
 		
-		exp = unparse_clast_expr(t->var);
+		/* a negative coefficient swaps the ends of the ranges */
+		exp = unparse_clast_expr(t->var, r, cloog_int_is_neg(t->val) ? !lower : lower);
+		if ( exp == NULL )
+			return NULL;
 		
 		if (group)
 			exp->set_need_paren(true);
@@ -236,18 +322,24 @@ SgExpression * RoseCloog::unparse_clast_expr_term( struct clast_term * t ) const
 }
 
 
-SgExpression * RoseCloog::unparse_clast_expr_red( struct clast_reduction * r ) const
+SgExpression * RoseCloog::unparse_clast_expr_red( struct clast_reduction * r, const clast_ranges * rg, bool lower ) const
 {
+	SgExpression * exp;
 	
 	switch (r->type) {
     	case clast_red_sum:
-			return unparse_clast_sum(r);
+			return unparse_clast_sum(r, rg, lower);
     	case clast_red_min:
     	case clast_red_max:
-			if (r->n == 1) {
-	    		return unparse_clast_expr(r->elts[0]);
+			/* bounding each element bounds the min/max of the elements */
+			exp = unparse_clast_expr(r->elts[0], rg, lower);
+			for ( int i = 1 ; exp != NULL && i < r->n ; i++ ) {
+				SgExpression * temp = unparse_clast_expr(r->elts[i], rg, lower);
+				if ( temp == NULL )
+					return NULL;
+				exp = (r->type == clast_red_min) ? build_min(exp,temp) : build_max(exp,temp);
 			}
-			break;
+			return exp;
     	default:
 			assert(0);
     }
@@ -255,6 +347,32 @@ SgExpression * RoseCloog::unparse_clast_expr_red( struct clast_reduction * r ) c
 	return NULL;
 }
 
+SgExpression * RoseCloog::unparse_clast_expr_bin( struct clast_binary * b, const clast_ranges * r, bool lower ) const
+{
+	SgExpression * lhs = unparse_clast_expr(b->LHS, r, lower);
+	if ( lhs == NULL )
+		return NULL;
+	
+	SgExpression * rhs = unparse_clast_integer(b->RHS);
+	
+	switch (b->type) {
+		case clast_bin_fdiv:
+			return build_floord(lhs,rhs);
+		case clast_bin_cdiv:
+			return build_ceild(lhs,rhs);
+		case clast_bin_div:
+			return buildDivideOp(lhs,rhs);
+		case clast_bin_mod:
+			/* not monotonic, cannot be bounded over ranges */
+			if ( r != NULL )
+				return NULL;
+			return buildModOp(lhs,rhs);
+		default:
+			assert(0);
+	}
+	return NULL;
+}
+
 SgIntVal * RoseCloog::unparse_clast_integer( cloog_int_t i ) const
 {								
 	char *s;
@@ -267,7 +385,7 @@ SgIntVal * RoseCloog::unparse_clast_integer( cloog_int_t i ) const
 	return val;				
 }
 
-SgExpression * RoseCloog::unparse_clast_sum( struct clast_reduction * r ) const
+SgExpression * RoseCloog::unparse_clast_sum( struct clast_reduction * r, const clast_ranges * rg, bool lower ) const
 {
 	
 	int i;
@@ -277,12 +395,16 @@ SgExpression * RoseCloog::unparse_clast_sum( struct clast_reduction * r ) const
     assert(r->n >= 1);
     assert(r->elts[0]->type == clast_expr_term);
     t = (struct clast_term *) r->elts[0];
-    exp = unparse_clast_expr_term(t);
+    exp = unparse_clast_expr_term(t, rg, lower);
+	if ( exp == NULL )
+		return NULL;
 	
     for (i = 1; i < r->n; ++i) {
 		assert(r->elts[i]->type == clast_expr_term);
 		t = (struct clast_term *) r->elts[i];
-		SgExpression * temp = unparse_clast_expr_term(t);
+		SgExpression * temp = unparse_clast_expr_term(t, rg, lower);
+		if ( temp == NULL )
+			return NULL;
 		if (cloog_int_is_pos(t->val)) {
 			exp = buildAddOp(exp, temp);
 	    } else {
@@ -292,6 +414,11 @@ SgExpression * RoseCloog::unparse_clast_sum( struct clast_reduction * r ) const
 				int value = isSgIntVal(temp)->get_value();
 				exp = buildSubtractOp(exp, buildIntVal(-value));
 				delete(temp);
+			} else {
+				/* negative multiple of a variable */
+				SgIntVal * coeff = isSgIntVal(isSgMultiplyOp(temp)->get_lhs_operand());
+				coeff->set_value(-coeff->get_value());
+				exp = buildSubtractOp(exp, temp);
 			}
 		}
     }
@@ -314,3 +441,397 @@ void RoseCloog::print( int ident ) const
 
 
 
+
+// CODE GENERATION
+
+void RoseCloog::generate_code( SgBasicBlock * kernel, const polly_codegen_options& o )
+{
+	if ( !ast )
+		return;
+	
+	gen_opts = o;
+	gen_vars.clear();
+	gen_iterators.clear();
+	gen_in_parallel = false;
+	gen_tiled = false;
+	
+	/* the iterators are declared at the top of the new block, the code follows them */
+	gen_block = buildBasicBlock();
+	replaceStatement(kernel,gen_block);
+	
+	SgBasicBlock * body = buildBasicBlock();
+	generate_clast(ast,body);
+	appendStatement(body,gen_block);
+	
+	if ( gen_tiled )
+		insertHeader("rosepoly/RosePollyRuntime.h",PreprocessingInfo::after,false,getGlobalScope(gen_block));
+	
+	gen_block = NULL;
+}
+
+int RoseCloog::get_loop_dim( struct clast_for * f ) const
+{
+	int dim;
+	if ( sscanf(f->iterator,"c%d",&dim) != 1 )
+		return -1;
+	return dim-1;
+}
+
+int RoseCloog::get_loop_level( int dim ) const
+{
+	if ( dim < 0 || dim >= bands.size() || bands[dim] < 0 )
+		return -1;
+	
+	int level = 0;
+	for ( int i = 0 ; i < dim ; i++ )
+		if ( bands[i] >= 0 )
+			level++;
+	return level;
+}
+
+loop_type RoseCloog::get_loop_type( struct clast_stmt * s, int dim ) const
+{
+	int level = get_loop_level(dim);
+	if ( level < 0 )
+		return UNDEFINED;
+	
+	loop_type type = PARALLEL;
+	for ( ; s ; s = s->next ) {
+		loop_type temp = PARALLEL;
+		if ( CLAST_STMT_IS_A(s, stmt_user) ) {
+			CloogStatement * stm = ((struct clast_user_stmt*)s)->statement;
+			temp = ((affineStatement*)stm->usr)->get_loop_type(level);
+		} else if ( CLAST_STMT_IS_A(s, stmt_for) ) {
+			temp = get_loop_type( ((struct clast_for*)s)->body, dim );
+		} else if ( CLAST_STMT_IS_A(s, stmt_guard) ) {
+			temp = get_loop_type( ((struct clast_guard*)s)->then, dim );
+		} else if ( CLAST_STMT_IS_A(s, stmt_block) ) {
+			temp = get_loop_type( ((struct clast_block*)s)->body, dim );
+		}
+		if ( temp == UNDEFINED )
+			return UNDEFINED;
+		if ( temp > type )
+			type = temp;
+	}
+	return type;
+}
+
+bool RoseCloog::is_innermost( struct clast_stmt * s ) const
+{
+	for ( ; s ; s = s->next ) {
+		if ( CLAST_STMT_IS_A(s, stmt_for) )
+			return false;
+		if ( CLAST_STMT_IS_A(s, stmt_guard) && !is_innermost( ((struct clast_guard*)s)->then ) )
+			return false;
+		if ( CLAST_STMT_IS_A(s, stmt_block) && !is_innermost( ((struct clast_block*)s)->body ) )
+			return false;
+	}
+	return true;
+}
+
+SgVarRefExp * RoseCloog::declare_variable( const string& name, SgExpression * init )
+{
+	if ( gen_vars.find(name) == gen_vars.end() ) {
+		gen_vars.insert(name);
+		SgAssignInitializer * value = init ? buildAssignInitializer(init) : NULL;
+		appendStatement( buildVariableDeclaration(name,buildIntType(),value,gen_block), gen_block );
+	}
+	return buildVarRefExp(name,gen_block);
+}
+
+SgVarRefExp * RoseCloog::declare_iterator( const string& name )
+{
+	gen_iterators.insert(name);
+	return declare_variable(name);
+}
+
+SgVarRefExp * RoseCloog::declare_tile_size( int dim )
+{
+	stringstream name;
+	name<<"T"<<dim+1;
+	gen_tiled = true;
+	
+	/* rose_polly_tile_size(level,default) is defined in rosepoly/RosePollyRuntime.h */
+	SgExprListExp * args = buildExprListExp( buildIntVal(get_loop_level(dim)+1), buildIntVal(gen_opts.tile_size) );
+	return declare_variable( name.str(), buildFunctionCallExp("rose_polly_tile_size",buildIntType(),args,gen_block) );
+}
+
+void RoseCloog::append_loop( SgBasicBlock * block, SgForStatement * loop, bool parallel, bool vector )
+{
+	if ( parallel ) {
+		/*
+		 *	The iterators are declared outside of the loop, so those written in the loop
+		 *	body (by the loops nested in it, or by assignments) must be private. The
+		 *	iterators of the enclosing loops are only read and stay shared: a private
+		 *	copy would be uninitialized.
+		 */
+		set<string> priv;
+		Rose_STL_Container<SgNode*> inner = NodeQuery::querySubTree(loop->get_loop_body(),V_SgForStatement);
+		for ( int i = 0 ; i < inner.size() ; i++ ) {
+			SgInitializedName * index = getLoopIndexVariable( isSgForStatement(inner[i]) );
+			if ( index != NULL && gen_iterators.find(index->get_name().getString()) != gen_iterators.end() )
+				priv.insert( index->get_name().getString() );
+		}
+		Rose_STL_Container<SgNode*> assigns = NodeQuery::querySubTree(loop->get_loop_body(),V_SgAssignOp);
+		for ( int i = 0 ; i < assigns.size() ; i++ ) {
+			SgVarRefExp * lhs = isSgVarRefExp( isSgAssignOp(assigns[i])->get_lhs_operand() );
+			if ( lhs != NULL && gen_iterators.find(lhs->get_symbol()->get_name().getString()) != gen_iterators.end() )
+				priv.insert( lhs->get_symbol()->get_name().getString() );
+		}
+		
+		string pragma = "omp parallel for";
+		for ( set<string>::iterator it = priv.begin() ; it != priv.end() ; it++ )
+			pragma += (it==priv.begin() ? " private(" : ",") + *it;
+		if ( !priv.empty() )
+			pragma += ")";
+		
+		appendStatement( buildPragmaDeclaration(pragma,block), block );
+	} else if ( vector ) {
+		appendStatement( buildPragmaDeclaration(gen_opts.vector_pragma,block), block );
+	}
+	appendStatement(loop,block);
+}
+
+void RoseCloog::generate_clast( struct clast_stmt * s, SgBasicBlock * block )
+{
+	for ( ; s ; s = s->next ) {
+		if ( CLAST_STMT_IS_A(s, stmt_root) )
+			continue;
+		
+		if ( CLAST_STMT_IS_A(s, stmt_ass) ) {
+			struct clast_assignment * a = (struct clast_assignment*)s;
+			SgVarRefExp * lhs = declare_iterator(a->LHS);
+			appendStatement( buildAssignStatement(lhs,unparse_clast_expr(a->RHS)), block );
+		} else if ( CLAST_STMT_IS_A(s, stmt_user) ) {
+			appendStatement( generate_user_stmt((struct clast_user_stmt*)s), block );
+		} else if ( CLAST_STMT_IS_A(s, stmt_for) ) {
+			generate_for( (struct clast_for*)s, block );
+		} else if ( CLAST_STMT_IS_A(s, stmt_guard) ) {
+			generate_guard( (struct clast_guard*)s, block );
+		} else if ( CLAST_STMT_IS_A(s, stmt_block) ) {
+			SgBasicBlock * inner = buildBasicBlock();
+			generate_clast( ((struct clast_block*)s)->body, inner );
+			appendStatement(inner,block);
+		} else {
+			assert(0);
+		}
+	}
+}
+
+SgStatement * RoseCloog::generate_user_stmt( struct clast_user_stmt * u ) const
+{
+	affineStatement * stm = (affineStatement*)u->statement->usr;
+	SgExprStatement * copy = deepCopy(stm->get_statement());
+	
+	/* the k-th substitution gives the value of the k-th original iterator */
+	vector<string> iters = stm->get_iterVector();
+	map<string,SgExpression*> values;
+	int k = 0;
+	for ( struct clast_stmt * sub = u->substitutions ; sub && k < iters.size() ; sub = sub->next, k++ )
+		values[iters[k]] = unparse_clast_expr( ((struct clast_assignment*)sub)->RHS );
+	
+	Rose_STL_Container<SgNode*> refs = NodeQuery::querySubTree(copy,V_SgVarRefExp);
+	for ( int i = 0 ; i < refs.size() ; i++ ) {
+		SgVarRefExp * ref = isSgVarRefExp(refs[i]);
+		map<string,SgExpression*>::iterator it = values.find( ref->get_symbol()->get_name().getString() );
+		if ( it != values.end() )
+			replaceExpression(ref,deepCopy(it->second));
+	}
+	return copy;
+}
+
+void RoseCloog::generate_guard( struct clast_guard * g, SgBasicBlock * block )
+{
+	SgExpression * cond = NULL;
+	for ( int i = 0 ; i < g->n ; i++ ) {
+		SgExpression * lhs = unparse_clast_expr(g->eq[i].LHS);
+		SgExpression * rhs = unparse_clast_expr(g->eq[i].RHS);
+		SgExpression * test;
+		if ( g->eq[i].sign == 0 )
+			test = buildEqualityOp(lhs,rhs);
+		else if ( g->eq[i].sign > 0 )
+			test = buildGreaterOrEqualOp(lhs,rhs);
+		else
+			test = buildLessOrEqualOp(lhs,rhs);
+		cond = cond ? buildAndOp(cond,test) : test;
+	}
+	
+	SgBasicBlock * then = buildBasicBlock();
+	generate_clast(g->then,then);
+	appendStatement( buildIfStmt(cond,then,NULL), block );
+}
+
+void RoseCloog::generate_for( struct clast_for * f, SgBasicBlock * block )
+{
+	if ( gen_opts.tile && generate_tiled_band(f,block) )
+		return;
+	
+	int dim = get_loop_dim(f);
+	bool parallel_loop = get_loop_type(f->body,dim) == PARALLEL;
+	bool parallel = gen_opts.parallel && !gen_in_parallel && parallel_loop;
+	bool vector = gen_opts.vectorize && parallel_loop && is_innermost(f->body);
+	
+	SgVarRefExp * it = declare_iterator(f->iterator);
+	SgBasicBlock * body = buildBasicBlock();
+	bool outer = gen_in_parallel;
+	gen_in_parallel = outer || parallel;
+	generate_clast(f->body,body);
+	gen_in_parallel = outer;
+	
+	SgExpression * step = cloog_int_is_one(f->stride) ? NULL : unparse_clast_integer(f->stride);
+	SgForStatement * loop = build_for(it,unparse_clast_expr(f->LB),unparse_clast_expr(f->UB),step,body);
+	append_loop(block,loop,parallel,vector);
+}
+
+/*
+ *	Tiles the loops of a permutable band that are perfectly nested from f.
+ *	The tile sizes are variables set at run time, so the tiles cannot be part
+ *	of the polyhedral schedule. Instead, the tile loops scan tiles of the
+ *	grid aligned on multiples of the tile sizes, from a lower to an upper
+ *	bound of the band loops over the points of the enclosing tiles (see
+ *	unparse_clast_expr), and the point loops clip the original bounds to
+ *	the current tile. Band permutability makes any rectangular tiling legal.
+ *
+ *	The outermost tile loop becomes an omp parallel for if the outermost
+ *	band dimension is parallel. Otherwise, the tiles of the first two
+ *	dimensions are run by wavefronts of tiles whose numbers have the same
+ *	sum, and the tiles of a wavefront run in parallel.
+ */
+bool RoseCloog::generate_tiled_band( struct clast_for * f, SgBasicBlock * block )
+{
+	int dim = get_loop_dim(f);
+	if ( dim < 0 || dim >= bands.size() || bands[dim] < 0 )
+		return false;
+	
+	/* STEP 1 : Find the perfectly nested loops of the band */
+	vector<struct clast_for*> loops;
+	vector<int> dims;
+	for ( struct clast_for * loop = f ; loop != NULL ; ) {
+		if ( !cloog_int_is_one(loop->stride) || !loop->LB || !loop->UB )
+			break;
+		loops.push_back(loop);
+		dims.push_back(get_loop_dim(loop));
+		
+		struct clast_stmt * body = loop->body;
+		loop = NULL;
+		if ( body && !body->next && CLAST_STMT_IS_A(body, stmt_for) ) {
+			int d = get_loop_dim((struct clast_for*)body);
+			if ( d >= 0 && d < bands.size() && bands[d] == bands[dim] )
+				loop = (struct clast_for*)body;
+		}
+	}
+	
+	int width = loops.size();
+	if ( width < 2 )
+		return false;
+	
+	/* nothing is declared before the band is known to be tiled */
+	for ( int k = 0 ; k < width ; k++ )
+		if ( !can_bound_clast_expr(loops[k]->LB) || !can_bound_clast_expr(loops[k]->UB) )
+			return false;
+	
+	/* STEP 2 : Bound the band loops over the enclosing tiles */
+	vector<SgVarRefExp*> tiles, sizes, points;
+	vector<SgExpression*> lower, upper;
+	clast_ranges ranges;
+	for ( int k = 0 ; k < width ; k++ ) {
+		stringstream name;
+		name<<"t"<<dims[k]+1;
+		tiles.push_back( declare_iterator(name.str()) );
+		sizes.push_back( declare_tile_size(dims[k]) );
+		points.push_back( declare_iterator(loops[k]->iterator) );
+		
+		SgExpression * lb = unparse_clast_expr(loops[k]->LB,&ranges,true);
+		SgExpression * ub = unparse_clast_expr(loops[k]->UB,&ranges,false);
+		assert( lb != NULL && ub != NULL );
+		lower.push_back(lb);
+		upper.push_back(ub);
+		
+		SgExpression * last = buildSubtractOp( buildAddOp(deepCopy(tiles[k]),deepCopy(sizes[k])), buildIntVal(1) );
+		ranges[loops[k]->iterator] = make_pair( (SgExpression*)tiles[k], last );
+	}
+	
+	/* STEP 3 : Choose the parallel dimension, or the range of the wavefronts */
+	int par = -1;
+	SgExpression * wave_lb = NULL;
+	SgExpression * wave_ub = NULL;
+	if ( gen_opts.parallel && !gen_in_parallel ) {
+		/*
+		 *	Only the outermost dimension can be parallel in the tile space. A deeper dimension
+		 *	is parallel for fixed values of the outer iterators, but an outer tile holds several
+		 *	of them, and the dependences between them may go both ways between its tiles.
+		 */
+		if ( get_loop_type(loops[0]->body,dims[0]) == PARALLEL )
+			par = 0;
+		
+		if ( par < 0 ) {
+			/* bounds of the second dimension over all the tiles of the first one */
+			clast_ranges all;
+			SgExpression * first = buildMultiplyOp( deepCopy(sizes[0]), build_floord(deepCopy(lower[0]),deepCopy(sizes[0])) );
+			SgExpression * last = buildSubtractOp( buildAddOp(deepCopy(upper[0]),deepCopy(sizes[0])), buildIntVal(1) );
+			all[loops[0]->iterator] = make_pair(first,last);
+			SgExpression * lb = unparse_clast_expr(loops[1]->LB,&all,true);
+			SgExpression * ub = unparse_clast_expr(loops[1]->UB,&all,false);
+			if ( lb != NULL && ub != NULL ) {
+				wave_lb = buildAddOp( build_floord(deepCopy(lower[0]),deepCopy(sizes[0])), build_floord(lb,deepCopy(sizes[1])) );
+				wave_ub = buildAddOp( build_floord(deepCopy(upper[0]),deepCopy(sizes[0])), build_floord(ub,deepCopy(sizes[1])) );
+			}
+		}
+	}
+	bool parallel = par >= 0 || wave_lb != NULL;
+	
+	/* STEP 4 : Point loops */
+	bool outer = gen_in_parallel;
+	gen_in_parallel = outer || parallel;
+	SgBasicBlock * body = buildBasicBlock();
+	generate_clast(loops[width-1]->body,body);
+	gen_in_parallel = outer;
+	
+	for ( int k = width-1 ; k >= 0 ; k-- ) {
+		SgExpression * lb = build_max( unparse_clast_expr(loops[k]->LB), deepCopy(tiles[k]) );
+		SgExpression * ub = build_min( unparse_clast_expr(loops[k]->UB), 
+					buildSubtractOp( buildAddOp(deepCopy(tiles[k]),deepCopy(sizes[k])), buildIntVal(1) ) );
+		bool vector = k == width-1 && gen_opts.vectorize && is_innermost(loops[k]->body) &&
+					  get_loop_type(loops[k]->body,dims[k]) == PARALLEL;
+		
+		SgBasicBlock * outerBody = buildBasicBlock();
+		append_loop( outerBody, build_for(deepCopy(points[k]),lb,ub,NULL,body), false, vector );
+		body = outerBody;
+	}
+	
+	/* STEP 5 : Tile loops, the first two are replaced by the wavefronts if any */
+	int first = (wave_lb != NULL) ? 2 : 0;
+	for ( int k = width-1 ; k >= first ; k-- ) {
+		SgExpression * start = buildMultiplyOp( deepCopy(sizes[k]), build_floord(lower[k],deepCopy(sizes[k])) );
+		SgForStatement * loop = build_for(deepCopy(tiles[k]),start,upper[k],deepCopy(sizes[k]),body);
+		if ( k == 0 ) {
+			append_loop(block,loop,par==0,false);
+			return true;
+		}
+		SgBasicBlock * outerBody = buildBasicBlock();
+		append_loop(outerBody,loop,false,false);
+		body = outerBody;
+	}
+	
+	/* in a wavefront, the tile of the first dimension fixes the one of the second */
+	stringstream name;
+	name<<"w"<<dims[0]+1;
+	SgVarRefExp * wave = declare_iterator(name.str());
+	
+	SgExpression * column = buildMultiplyOp( buildSubtractOp( deepCopy(wave), buildDivideOp(deepCopy(tiles[0]),deepCopy(sizes[0])) ),
+											deepCopy(sizes[1]) );
+	SgExpression * in_band = buildAndOp(
+		buildGreaterOrEqualOp( deepCopy(tiles[1]), buildMultiplyOp(deepCopy(sizes[1]),build_floord(lower[1],deepCopy(sizes[1]))) ),
+		buildLessOrEqualOp( deepCopy(tiles[1]), upper[1] ) );
+	
+	SgBasicBlock * row = buildBasicBlock();
+	appendStatement( buildAssignStatement(deepCopy(tiles[1]),column), row );
+	appendStatement( buildIfStmt(in_band,body,NULL), row );
+	
+	SgExpression * start = buildMultiplyOp( deepCopy(sizes[0]), build_floord(lower[0],deepCopy(sizes[0])) );
+	SgBasicBlock * front = buildBasicBlock();
+	append_loop( front, build_for(deepCopy(tiles[0]),start,upper[0],deepCopy(sizes[0]),row), true, false );
+	
+	append_loop( block, build_for(wave,wave_lb,wave_ub,NULL,front), false, false );
+	return true;
+}
@@ -39,16 +39,21 @@ void RosePluto::apply( fuse_type ft )
 	cout<<"[PLUTO]"<<endl;
 	// cout<<"TOTAL DEPS = "<<deps.size()<<endl;
 	
+	/* the hyperplanes found in one round form a permutable band */
+	int num_bands = 0;
+	
 	switch (ft)
 	{
 		case NO_FUSE:
 			cut_all_sccs(1);
 			h_types.push_back(SCALAR);
+			bands.push_back(-1);
 			solSize++;
 			break;
 		case SMART_FUSE:
 			if ( cut_sccs_dim_based(1) ) {
 				h_types.push_back(SCALAR);
+				bands.push_back(-1);
 				solSize++;
 			}
 			break;
@@ -64,6 +69,7 @@ void RosePluto::apply( fuse_type ft )
 		if ( sols_temp ) {
 			for ( int i = 0 ; i < sols_temp ; i++ ) {
 				h_types.push_back(LOOP);
+				bands.push_back(num_bands);
 				/* cout<<"satisfied deps = "<<dep_satisfaction_update(solSize+i)<<endl;
 				for ( int j = 0 ; j < deps.size() ; j++ )
 					if ( deps[j]->isSatisfied() )
@@ -72,9 +78,11 @@ void RosePluto::apply( fuse_type ft )
 				ddg_update();
 			}
 			solSize += sols_temp;
+			num_bands++;
 		} else {
 			// cout<<"adding a scalar"<<endl;
 			h_types.push_back(SCALAR);
+			bands.push_back(-1);
 			solSize += 1;
 			compute_scc();
 			
@@ -195,6 +195,12 @@ RoseCloog * RosePollyBuildCloog( RosePollyModel * model )
 	return cloog;
 }
 
+void RosePollyGenerateCode( RoseCloog * cloog, const polly_codegen_options& opts )
+{
+	Kernel * k = kernel_map[cloog->get_id()];
+	cloog->generate_code( k->get_scope(), opts );
+}
+
 void RosePollyTerminate()
 {
 	for ( int i = 0 ; i < live_objects.size() ; i++ )
@@ -25,7 +25,7 @@ RosePollyModel::RosePollyModel() : ddg(NULL), ID(-1) {}
 
 RosePollyModel::RosePollyModel( const RosePollyModel& model )
 : parameters(model.parameters), data(model.get_data()), ID(model.ID),
-ddg(NULL)
+bands(model.bands), ddg(NULL)
 {
 	if ( model.ddg != NULL )
 		ddg = new simple_multi_graph(*model.ddg);
@@ -15,7 +15,15 @@ using namespace std;
 
 int main(int argc, char * argv[]) {
 	
-	SgProject * proj = frontend(argc,argv);
+	/* -rosepolly:notile, -rosepolly:noparallel, -rosepolly:novector, -rosepolly:tile_size <n> */
+	vector<string> args(argv,argv+argc);
+	polly_codegen_options opts;
+	opts.tile = !CommandlineProcessing::isOption(args,"-rosepolly:","notile",true);
+	opts.parallel = !CommandlineProcessing::isOption(args,"-rosepolly:","noparallel",true);
+	opts.vectorize = !CommandlineProcessing::isOption(args,"-rosepolly:","novector",true);
+	CommandlineProcessing::isOptionWithParameter(args,"-rosepolly:","tile_size",opts.tile_size,true);
+	
+	SgProject * proj = frontend(args);
 	
 	vector<RosePollyModel*> kernels = RosePollyBuildModel(proj);
 	
@@ -23,7 +31,9 @@ int main(int argc, char * argv[]) {
 		
 		RosePluto * pluto = RosePollyBuildPluto(kernels[i]);
 		pluto->apply(SMART_FUSE);
-		pluto->loop_skewing(3,false);
+		/* the tiles get their own wavefronts */
+		if ( !opts.tile )
+			pluto->loop_skewing(3,false);
 		pluto->print(2);
 		
 		RoseCloog * cloog = RosePollyBuildCloog(pluto);
@@ -34,6 +44,8 @@ int main(int argc, char * argv[]) {
 		cloog->print_to_screen();
 		/* FlowGraph * graph = cloog->print_to_flow_graph();
 		graph->print(2); */
+		
+		RosePollyGenerateCode(cloog,opts);
 	}
 	RosePollyTerminate();
 	
@@ -1,106 +1,232 @@
 #pragma once
 
 #include <cstdlib>
+#include <cstring>
 #include <deque>
+#include <vector>
 #include <cassert>
 #include <stdint.h>
 
 #define __BACKSTROKE
 
-//! Should be called at the very beginning of the forward event. Marks the current height of all the stacks.
+//! Should be called at the very beginning of the forward event. Marks the current end of the rollback log.
 void __initialize_forward_event();
 
 //! Should be called at the very last point before the exit from a forward event. Saves information about the size &
-//! contents of the rollback stack.
+//! contents of the rollback log.
 void __finalize_forward_event();
 
 //! Read the information from the processing record at the bottom of the event processing stack and perform
-//! commit actions - freeing stacks, deallocating memory, and commiting delayed output
+//! commit actions - discarding the event's log records, deallocating memory, and commiting delayed output
 void __commit();
 
-//There are four data stacks, one for each primitive type that shares the same size.
-extern std::deque<int8_t> rollback_stack_8;
-extern std::deque<int16_t> rollback_stack_16;
-extern std::deque<int32_t> rollback_stack_32;
-extern std::deque<int64_t> rollback_stack_64;
+//! Size of the chunks the rollback log is made of. Committed chunks are recycled rather than freed.
+const size_t ROLLBACK_LOG_CHUNK_SIZE = 64 * 1024;
 
-//The function push(T) pushes variables on the appropriate stack based on their size.
-//It is overloaded for all scalar types
-template <typename T>
-inline void __push(T val)
+//! One contiguous piece of the rollback log. Records never straddle two chunks.
+struct RollbackLogChunk
+{
+	//! Sequence number of the chunk in its log; increases every time a chunk is (re)used
+	size_t serial;
+
+	//! End of the records in this chunk. Only up to date for chunks other than the last one
+	char* fill;
+
+	char* begin() { return reinterpret_cast<char*>(this + 1); }
+	char* end() { return begin() + ROLLBACK_LOG_CHUNK_SIZE; }
+};
+
+//! A position in the rollback log.
+struct RollbackLogMark
 {
-	assert(false && "Use the appropriate template specialization of push\n");
+	size_t serial;
+	size_t offset;
+};
+
+//! The state saved by forward events. Each thread has its own log, so events executed by different
+//! threads never contend. Values are stored as typed records: the bytes of the value followed by a one-byte
+//! type tag, which is checked when the value is popped.
+struct RollbackLog
+{
+	//! Chunks in use, oldest first. The last one is being written to.
+	std::deque<RollbackLogChunk*> chunks;
+
+	//! Committed chunks, ready to be reused
+	std::vector<RollbackLogChunk*> freeChunks;
+
+	//! Write position and end of the last chunk
+	char* top;
+	char* limit;
+
+	size_t nextSerial;
+
+	//! Returns space for size bytes of records at the end of the log.
+	char* reserve(size_t size)
+	{
+		if (static_cast<size_t>(limit - top) < size)
+			grow();
+		char* record = top;
+		top += size;
+		return record;
+	}
+
+	//! Returns the record of size bytes at the end of the log and removes it.
+	char* release(size_t size)
+	{
+		if (top == chunks.back()->begin())
+			shrink();
+		assert(static_cast<size_t>(top - chunks.back()->begin()) >= size);
+		top -= size;
+		return top;
+	}
+
+	RollbackLogMark mark() const;
+
+	//! Moves to a new chunk. Called when the last one is full.
+	void grow();
+
+	//! Moves back to the previous chunk. Called when the last one is empty.
+	void shrink();
+
+	//! Discards all the records before the mark.
+	void discardBefore(const RollbackLogMark& m);
+};
+
+//! The rollback log of the calling thread, or NULL before its first forward event
+extern __thread RollbackLog* __current_rollback_log;
+
+//! Creates the runtime state of the calling thread and returns its rollback log.
+RollbackLog& __create_rollback_log();
+
+//! The rollback log of the calling thread.
+inline RollbackLog& __rollback_log()
+{
+	RollbackLog* log = __current_rollback_log;
+	return log != NULL ? *log : __create_rollback_log();
 }
 
-#define DECLARE_PUSH(type, stack_size) \
-template<> \
-inline void __push(type val) \
+//! RollbackTypeTag<T>::value identifies records of type T. It is only defined for the types that can be pushed.
+template <typename T>
+struct RollbackTypeTag;
+
+#define DECLARE_ROLLBACK_TYPE_TAG(type, tag) \
+template <> \
+struct RollbackTypeTag<type> \
 { \
-	assert(sizeof(type) == stack_size >> 3); \
-	int##stack_size##_t* casted_val = reinterpret_cast<int##stack_size##_t*>(&val); \
-	rollback_stack_ ## stack_size.push_back(*casted_val); \
-} 
-
-//Declare the push functions for all the basic integral types
-DECLARE_PUSH(char, 8);
-DECLARE_PUSH(short int, 16);
-DECLARE_PUSH(int, 32);
-DECLARE_PUSH(long int, 64);
-DECLARE_PUSH(long long int, 64);
-DECLARE_PUSH(unsigned char, 8);
-DECLARE_PUSH(unsigned short int, 16);
-DECLARE_PUSH(unsigned int, 32);
-DECLARE_PUSH(unsigned long int, 64);
-DECLARE_PUSH(unsigned long long int, 64);
-
-//Declare push functions for the floating point types
-DECLARE_PUSH(float, 32);
-DECLARE_PUSH(double, 64);
-
-//Declare push function for pointers
-template<>
-inline void __push(void* val)
-{
-	assert(sizeof(void*) == sizeof(int64_t));
-	rollback_stack_64.push_back(reinterpret_cast<int64_t>(val));
+	static const char value = tag; \
+};
+
+DECLARE_ROLLBACK_TYPE_TAG(bool, 1)
+DECLARE_ROLLBACK_TYPE_TAG(char, 2)
+DECLARE_ROLLBACK_TYPE_TAG(signed char, 3)
+DECLARE_ROLLBACK_TYPE_TAG(unsigned char, 4)
+DECLARE_ROLLBACK_TYPE_TAG(short int, 5)
+DECLARE_ROLLBACK_TYPE_TAG(unsigned short int, 6)
+DECLARE_ROLLBACK_TYPE_TAG(int, 7)
+DECLARE_ROLLBACK_TYPE_TAG(unsigned int, 8)
+DECLARE_ROLLBACK_TYPE_TAG(long int, 9)
+DECLARE_ROLLBACK_TYPE_TAG(unsigned long int, 10)
+DECLARE_ROLLBACK_TYPE_TAG(long long int, 11)
+DECLARE_ROLLBACK_TYPE_TAG(unsigned long long int, 12)
+DECLARE_ROLLBACK_TYPE_TAG(float, 13)
+DECLARE_ROLLBACK_TYPE_TAG(double, 14)
+DECLARE_ROLLBACK_TYPE_TAG(long double, 15)
+
+//Pointers of all types share one tag
+template <typename T>
+struct RollbackTypeTag<T*>
+{
+	static const char value = 16;
+};
+
+//! Size of the record holding a value of type T.
+template <typename T>
+struct RollbackRecordSize
+{
+	static const size_t value = sizeof(T) + 1;
+};
+
+template <typename T>
+inline void __write_record(char* record, T val)
+{
+	memcpy(record, &val, sizeof(T));
+	record[sizeof(T)] = RollbackTypeTag<T>::value;
 }
 
+template <typename T>
+inline T __read_record(const char* record)
+{
+	assert(record[sizeof(T)] == RollbackTypeTag<T>::value && "Popped a value of the wrong type");
+	T val;
+	memcpy(&val, record, sizeof(T));
+	return val;
+}
 
-//The function pop_back<T> pops a variable from the appropriate stack and returns it.
-//The template type T is used to decide which stack to use
+//The function push(T) appends a variable to the rollback log of the current thread.
+//The overloads taking several values save them with a single reservation; the values are
+//restored by popping them in the reverse order, or with the matching __pop_back overload.
 template <typename T>
-inline T __pop_back()
+inline void __push(T val)
 {
-	assert(false && "Use the appropriate template specialization.");
+	__write_record(__rollback_log().reserve(RollbackRecordSize<T>::value), val);
 }
 
-#define DECLARE_POP_BACK(type, stack_size) \
-template <> \
-inline type __pop_back() \
-{ \
-	assert(sizeof(type) == stack_size >> 3); \
-	int##stack_size##_t val = rollback_stack_##stack_size.back(); \
-	rollback_stack_##stack_size.pop_back(); \
-	\
-	type* castedVal = reinterpret_cast<type*>(&val); \
-	\
-	return *castedVal; \
+template <typename T1, typename T2>
+inline void __push(T1 val1, T2 val2)
+{
+	char* record = __rollback_log().reserve(RollbackRecordSize<T1>::value + RollbackRecordSize<T2>::value);
+	__write_record(record, val1);
+	__write_record(record + RollbackRecordSize<T1>::value, val2);
+}
+
+template <typename T1, typename T2, typename T3>
+inline void __push(T1 val1, T2 val2, T3 val3)
+{
+	const size_t size1 = RollbackRecordSize<T1>::value, size2 = RollbackRecordSize<T2>::value;
+	char* record = __rollback_log().reserve(size1 + size2 + RollbackRecordSize<T3>::value);
+	__write_record(record, val1);
+	__write_record(record + size1, val2);
+	__write_record(record + size1 + size2, val3);
+}
+
+template <typename T1, typename T2, typename T3, typename T4>
+inline void __push(T1 val1, T2 val2, T3 val3, T4 val4)
+{
+	const size_t size1 = RollbackRecordSize<T1>::value, size2 = RollbackRecordSize<T2>::value,
+			size3 = RollbackRecordSize<T3>::value;
+	char* record = __rollback_log().reserve(size1 + size2 + size3 + RollbackRecordSize<T4>::value);
+	__write_record(record, val1);
+	__write_record(record + size1, val2);
+	__write_record(record + size1 + size2, val3);
+	__write_record(record + size1 + size2 + size3, val4);
 }
 
-//Declare the pop_back functions for all the basic integral types
-DECLARE_POP_BACK(char, 8);
-DECLARE_POP_BACK(unsigned char, 8);
-DECLARE_POP_BACK(short int, 16);
-DECLARE_POP_BACK(unsigned short int, 16);
-DECLARE_POP_BACK(int, 32);
-DECLARE_POP_BACK(unsigned int, 32);
-DECLARE_POP_BACK(long int, 64);
-DECLARE_POP_BACK(unsigned long int, 64);
-DECLARE_POP_BACK(long long int, 64);
-DECLARE_POP_BACK(unsigned long long int, 64);
 
-//Declare the pop_back functions for the floating point types
-DECLARE_POP_BACK(float, 32);
-DECLARE_POP_BACK(double, 64);
+//The function pop_back<T> removes the last record from the rollback log and returns its value.
+//The template type T must be the type the value was pushed with.
+template <typename T>
+inline T __pop_back()
+{
+	return __read_record<T>(__rollback_log().release(RollbackRecordSize<T>::value));
+}
 
+template <typename T1, typename T2>
+inline void __pop_back(T1& val1, T2& val2)
+{
+	val2 = __pop_back<T2>();
+	val1 = __pop_back<T1>();
+}
 
+template <typename T1, typename T2, typename T3>
+inline void __pop_back(T1& val1, T2& val2, T3& val3)
+{
+	val3 = __pop_back<T3>();
+	__pop_back(val1, val2);
+}
+
+template <typename T1, typename T2, typename T3, typename T4>
+inline void __pop_back(T1& val1, T2& val2, T3& val3, T4& val4)
+{
+	val4 = __pop_back<T4>();
+	__pop_back(val1, val2, val3);
+}
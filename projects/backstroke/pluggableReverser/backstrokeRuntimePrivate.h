@@ -2,6 +2,7 @@
 
 #include <unistd.h>
 #include <deque>
+#include "backstrokeRuntime.h"
 
 // This file is NOT to be included by transformed programs. It is here simply to assist in implementing the runtime.
 
@@ -9,22 +10,33 @@
 //! A record gets created for each event function, but not for non-event functions.
 struct EventProcessingRecord
 {
-	size_t stack8_pushes;
-	size_t stack16_pushes;
-	size_t stack32_pushes;
-	size_t stack64_pushes;
-	size_t deallocation_stack_pushes;
+	//! End of the event's records in the rollback log
+	RollbackLogMark log_end;
+	size_t deallocation_pushes;
 	
 	EventProcessingRecord() : 
-		stack8_pushes(-1),
-		stack16_pushes(-1),
-		stack32_pushes(-1),
-		stack64_pushes(-1),
-		deallocation_stack_pushes(-1)
+		deallocation_pushes(-1)
 	{ }
 };
 
+//! The per-thread state of the runtime.
+struct ThreadRuntimeState
+{
+	RollbackLog log;
+
+	//! This stack contains exactly one EventProcessingRecord object for each event processed by the thread.
+	//! Processing the forward function causes the a new processing record to be appended to the back of the stack
+	std::deque<EventProcessingRecord> event_processing_stack;
+
+	//! Blocks to be deleted when the event that released them is committed
+	std::deque<void*> deallocation_stack;
+
+	//! Size of the deallocation stack when the current forward event started, or INVALID
+	size_t deallocation_marker;
+
+	ThreadRuntimeState();
+	~ThreadRuntimeState();
+};
 
-//! This stack contains exactly one EventProcessingRecord object for each event processed.
-//! Processing the forward function causes the a new processing record to be appended to the back of the stack
-extern std::deque<EventProcessingRecord> event_processing_stack;
\ No newline at end of file
+//! The runtime state of the calling thread. Created on first use and destroyed when the thread exits.
+ThreadRuntimeState& __thread_runtime_state();
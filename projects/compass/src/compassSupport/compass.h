@@ -384,6 +384,17 @@ namespace Compass {
 #ifdef HAVE_SQLITE3
   // Output to SQLITE database
   void outputDb( std::string  dbName, std::vector<const Compass::Checker*> & checkers, Compass::OutputObject *output );
+
+  // Incremental analysis: create the tables of the output database (Compass::con)
+  void createResultTables();
+  // Incremental analysis: signature of everything (other than the input files) that affects checker results, including the checker binaries
+  std::string computeRunSignature( const std::string & parameterFile, const std::vector<const Compass::Checker*> & checkers );
+  // Incremental analysis: signature of the preprocessed source file, its preprocessor options and the run signature
+  std::string computeFileSignature( SgSourceFile* sourceFile, const std::string & runSignature );
+  // Incremental analysis: true if the violations stored in the output database for this file are up to date
+  bool isResultCached( const std::string & filename, const std::string & signature );
+  // Incremental analysis: record the signature of a file whose violations were just written to the output database
+  void updateResultCache( const std::string & filename, const std::string & signature );
 #endif
 
   #include "prerequisites.h"
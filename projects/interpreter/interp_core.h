@@ -30,6 +30,7 @@ enum Context
 
 class StackFrame;
 class Value;
+class FlatArena;
 
 typedef boost::shared_ptr<StackFrame> StackFrameP;
 typedef boost::shared_ptr<Value> ValueP;
@@ -1144,18 +1145,24 @@ class Interpretation
 
      private:
      mutable builtins_t *_builtinFns;
+     FlatArena *_flatArena;
 
      protected:
      virtual void registerBuiltinFns(builtins_t &builtins) const;
 
      public:
-     bool trace, errorTrace;
+     bool trace, errorTrace, flat;
+     //! The number of loops run to completion in the flat mode.
+     unsigned long flatLoops;
      varBindings_t globalVarBindings;
 
      Interpretation();
 
      const builtins_t &builtinFns() const;
 
+     //! The arena holding the state of loops run in the flat mode (see interp_flat.h).
+     FlatArena &flatArena();
+
      virtual void parseCommandLine(std::vector<std::string> &args);
 
      /*! The purpose of this function is to allow the interpretation
@@ -1164,6 +1171,10 @@ class Interpretation
          allows the interpretation to save the state for a rollback. */
      virtual void prePrimAssign(ValueP lhs, const_ValueP rhs, SgType *lhsApt, SgType *rhsApt);
 
+     /*! Returns true if prePrimAssign is overridden.  The flat mode, which only
+         assigns the final values of a loop, is then disabled. */
+     virtual bool hooksPrimAssign() const;
+
      virtual ~Interpretation();
    };
 
@@ -1307,6 +1318,12 @@ class StackFrame : public boost::enable_shared_from_this<StackFrame>
      ValueP evalStmtAsExpr(SgStatement *stmt, blockScopeVars_t &blockScope);
      void mainEvalLoop(BlockStackFrameP &curFrame);
 
+     ValueP flatBinding(SgVariableSymbol *sym);
+
+     /*! Runs the given loop in the flat mode, if enabled and if the loop can be
+         translated.  Returns false if the loop is left to evalStmt. */
+     bool evalFlatLoop(SgStatement *loop);
+
      virtual ValueP newArray(SgArrayType *at, Position pos, Context ctx);
      ValueP newClassValue(SgClassType *ct, Position pos);
      ValueP newTypedefValue(SgTypedefType *tt, Position pos, Context ctx);
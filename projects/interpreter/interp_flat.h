@@ -0,0 +1,188 @@
+#ifndef INTERP_FLAT_H
+#define INTERP_FLAT_H
+
+#include <vector>
+#include <interp_core.h>
+
+namespace Interp {
+
+/* The flat execution mode (-interp:flat) runs loop nests that only use scalar
+   variables and arrays of primitive type through a compact register bytecode
+   instead of the Value tree.  Each loop is translated once, the first time it is
+   reached, and the result (or the fact that it could not be translated) is cached
+   on the loop statement.  At run time variables live in tagged unboxed slots and
+   arrays in byte buffers laid out with typeLayout(), all allocated from the
+   FlatArena of the Interpretation.  The Value tree is read lazily and only updated
+   once the loop has completed, with the final values; if the loop raises an
+   InterpError, its flat effects are discarded and the tree interpreter runs it
+   instead.  Interpretations that hook prePrimAssign never use the flat mode. */
+
+#define FOREACH_FLAT_INTEGRAL_KIND(kind) \
+        kind(bool,Bool) \
+        kind(char,Char) \
+        kind(short,Short) \
+        kind(int,Int) \
+        kind(long int,Long) \
+        kind(long long int,LongLong) \
+        kind(unsigned char,UnsignedChar) \
+        kind(unsigned short,UnsignedShort) \
+        kind(unsigned int,UnsignedInt) \
+        kind(unsigned long,UnsignedLong) \
+        kind(unsigned long long int,UnsignedLongLong)
+
+#define FOREACH_FLAT_FP_KIND(kind) \
+        kind(float,Float) \
+        kind(double,Double) \
+        kind(long double,LongDouble)
+
+#define FOREACH_FLAT_KIND(kind) \
+        FOREACH_FLAT_INTEGRAL_KIND(kind) \
+        FOREACH_FLAT_FP_KIND(kind)
+
+enum FlatKind
+   {
+#define FLAT_KIND_ENUM(type,name) FK##name,
+     FOREACH_FLAT_KIND(FLAT_KIND_ENUM)
+#undef FLAT_KIND_ENUM
+     FKNone
+   };
+
+union FlatScalar
+   {
+#define FLAT_SCALAR_MEMBER(type,name) type v##name;
+     FOREACH_FLAT_KIND(FLAT_SCALAR_MEMBER)
+#undef FLAT_SCALAR_MEMBER
+   };
+
+//! An unboxed value; valid plays the role of BasePrimValue::isValid.
+struct FlatSlot
+   {
+     FlatScalar v;
+     bool valid;
+   };
+
+/*! Storage for an array accessed by flat code.  Only the window [lo, hi) of the
+    count elements touched so far is held, allocated from arena.  Elements are
+    copied from the Value tree on first use; state holds the FLAT_ELEM_* flags of
+    each element of the window. */
+struct FlatArrayState
+   {
+     Value *base;
+     size_t count, elemSize;
+     FlatArena *arena;
+     size_t lo, hi;
+     char *data;
+     unsigned char *state;
+   };
+
+enum
+   {
+     FLAT_ELEM_LOADED = 1,
+     FLAT_ELEM_VALID = 2,
+     FLAT_ELEM_DIRTY = 4
+   };
+
+/*! Bump allocator for the slots and array buffers of flat code.  Allocations
+    are released in LIFO order with mark() and release().  Each Interpretation
+    owns one, so every interpreting thread has its own arena. */
+class FlatArena
+   {
+     std::vector<std::pair<char *, size_t> > chunks;
+     size_t chunk, used;
+
+     public:
+     struct Mark
+        {
+          size_t chunk, used;
+        };
+
+     FlatArena();
+
+     void *allocate(size_t size);
+     Mark mark() const;
+     void release(const Mark &m);
+
+     ~FlatArena();
+   };
+
+typedef void (*FlatUnaryFn)(FlatSlot &dst, const FlatSlot &opd);
+typedef void (*FlatBinaryFn)(FlatSlot &dst, const FlatSlot &lhs, const FlatSlot &rhs);
+typedef int (*FlatIntFn)(const FlatSlot &opd);
+typedef void (*FlatLoadFn)(FlatArrayState &arr, long index, FlatSlot &dst);
+typedef void (*FlatStoreFn)(FlatArrayState &arr, long index, const FlatSlot &src);
+
+enum FlatOpcode
+   {
+     FIUnary,       // dst = fn.unary(a)
+     FIBinary,      // dst = fn.binary(a, b)
+     FIConst,       // dst = imm
+     FIUndef,       // dst = <<undefined>>
+     FIJump,        // goto target
+     FIJumpIfFalse, // if (!(int)a) goto target, throws if a is undefined
+     FIJumpIfSC,    // if (a is undefined || (int)a == b) goto target
+     FIIndex,       // dst = (a < 0 ? 0 : a*extent) + b, with 0 <= b < extent (if extent != 0)
+     FILoad,        // dst = arrays[b][a]
+     FIStore,       // arrays[b][a] = dst
+     FIHalt
+   };
+
+struct FlatInstr
+   {
+     FlatOpcode op;
+     union
+        {
+          FlatUnaryFn unary;
+          FlatBinaryFn binary;
+          FlatIntFn toInt;
+          FlatLoadFn load;
+          FlatStoreFn store;
+        } fn;
+     int dst, a, b;
+     size_t target;
+     FlatScalar imm;
+   };
+
+typedef bool (*FlatFetchFn)(const_ValueP prim, FlatSlot &dst);
+typedef ValueP (*FlatMakeFn)(const void *v, bool valid, StackFrameP owner);
+
+//! A variable referenced by flat code.
+struct FlatVar
+   {
+     SgVariableSymbol *sym;
+     FlatKind kind;
+     int slot;
+     bool outer;   // bound outside the loop: loaded on entry
+     bool written; // outer and assigned: stored back on exit
+     FlatFetchFn fetch;
+     FlatMakeFn make;
+   };
+
+//! An array referenced by flat code.
+struct FlatArray
+   {
+     SgVariableSymbol *sym;
+     SgType *elemType;
+     FlatKind kind;
+     size_t elemSize;
+     FlatMakeFn make;
+   };
+
+/*! The translation of one loop.  Each variable has its own slot (FlatVar::slot);
+    the other slots hold temporaries. */
+struct FlatCode
+   {
+     std::vector<FlatInstr> instrs;
+     std::vector<FlatVar> vars;
+     std::vector<FlatArray> arrays;
+     size_t numSlots;
+
+     void run(FlatSlot *slots, FlatArrayState *arrayStates) const;
+
+     /*! Translates the given loop statement, or returns NULL if it uses something
+         the flat mode does not support (calls, pointers, structures, return...). */
+     static FlatCode *compile(SgStatement *loop, SgFile::outputLanguageOption_enum language);
+   };
+
+}; // namespace Interp
+
+#endif
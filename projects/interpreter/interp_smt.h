@@ -177,6 +177,7 @@ class SMTInterpretation : public Interpretation
 
        void parseCommandLine(std::vector<std::string> &args);
        void prePrimAssign(ValueP lhs, const_ValueP rhs, SgType *lhsApt, SgType *rhsApt);
+       bool hooksPrimAssign() const;
 
      };
 
@@ -0,0 +1,62 @@
+int grid[4][5];
+double weights[8];
+
+static int square(int v)
+   {
+     return v * v;
+   }
+
+int test(int x)
+   {
+     int i, j, sum = 0;
+     unsigned int bits = 0;
+     long acc = 0;
+     double total = 0.0;
+
+     for (i = 0; i < 4; ++i)
+        {
+          for (j = 0; j < 5; j++)
+             {
+               grid[i][j] = i * 5 + j;
+             }
+        }
+
+     for (i = 0; i < 8; i++)
+          weights[i] = i / 2.0;
+
+     i = 0;
+     while (i < 4)
+        {
+          j = 0;
+          do
+             {
+               if (grid[i][j] % 3 == 0)
+                  {
+                    j++;
+                    continue;
+                  }
+               sum += grid[i][j] > 10 ? grid[i][j] - 10 : grid[i][j];
+               j++;
+             }
+          while (j < 5);
+          if (sum > 60 && i != 2)
+               break;
+          i++;
+        }
+
+     for (int k = 0; k < 8; k++)
+        {
+          total += weights[k] * 2;
+          bits |= 1u << k;
+          bits ^= (unsigned int)k;
+          acc -= k--;
+          acc += (long)(k++ + x);
+          grid[k % 4][k % 5] *= 2;
+          grid[0][0] += !(k & 1) || k == 5;
+        }
+
+     for (i = 0; i < 3; i++)
+          acc += square(i);
+
+     return sum + (int)total + (int)(bits & 0xff) + (int)acc + grid[0][0] + grid[3][3];
+   }
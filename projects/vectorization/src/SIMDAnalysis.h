@@ -4,9 +4,34 @@
 #include "rose.h"
 #include "sageBuilder.h"
 #include "DefUseAnalysis.h"
+#include <vector>
 
 namespace SIMDAnalysis
 {
+//  A scalar accumulated by the iterations of a loop: s += e, s -= e, s *= e, s = s + e, s = s - e or s = s * e.
+  struct Reduction
+  {
+    SgInitializedName* variable;
+//  V_SgAddOp for sums (including s -= e), V_SgMultiplyOp for products
+    VariantT operation;
+  };
+
+//  What isVectorizableLoop() finds out about a loop
+  struct VectorizableLoopInfo
+  {
+    SgInitializedName* index;
+    SgExpression* lowerBound;
+//  inclusive, as the loop is normalized
+    SgExpression* upperBound;
+//  the element type of all the vector operations: float, double or int
+    SgType* elementType;
+    std::vector<Reduction> reductions;
+//  loop invariant scalars used as vector operands; they are splatted once before the vector loop
+    std::vector<SgInitializedName*> invariants;
+//  the array reference whose address the loop is peeled to align, or NULL
+    SgPntrArrRefExp* alignmentReference;
+  };
+
 //  Get the Def information
   void getDefList(DFAnalysis*, SgNode*);
 //  Get the Use information
@@ -15,6 +40,13 @@ namespace SIMDAnalysis
   bool isInnermostLoop(SgNode*);
 //  Check if the loop has stride distance 1  
   bool isStrideOneLoop(SgNode*);
+//  Check if the array reference walks along the loop index, i.e. its last subscript is index +/- an invariant
+  bool isUnitStrideReference(SgPntrArrRefExp*, SgInitializedName*);
+//  Check if the body of a normalized innermost loop can be translated to SIMD operations, and collect the information
+//  needed by the translation.  Dependences between array references are checked separately.
+  bool isVectorizableLoop(SgForStatement*, VectorizableLoopInfo&);
+//  Check if the loop carries a dependence that executing VF iterations at once would violate
+  bool hasVectorizationPreventingDependence(SgForStatement*);
 
 }
 
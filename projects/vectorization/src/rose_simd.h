@@ -1,87 +1,331 @@
 /*
   A common layer for different SIMD intrinsics.
+
+  The vectorizer generates calls to the _SIMD_ functions declared here, and this header maps them to the
+  intrinsic functions of the target.  The instruction set is selected from the compiler flags:
+  AVX2 when the compiler targets it (-mavx2), SSE2 otherwise.  Defining USE_SSE, USE_AVX2 or USE_IBM
+  before including the header overrides the selection.
+
+  The functions are defined static inline so that the intrinsics are expanded in the vector loops.
+  rosesimd.c defines ROSE_SIMD_LIBRARY to build the same functions as the external libsimd library.
 */
-#ifndef LIB_SIMD_H 
+#ifndef LIB_SIMD_H
 #define LIB_SIMD_H
 
+#if !defined(USE_SSE) && !defined(USE_AVX2) && !defined(USE_IBM)
+#ifdef __AVX2__
+#define USE_AVX2 1
+#else
 #define USE_SSE 1
+#endif
+#endif
+
+#ifdef ROSE_SIMD_LIBRARY
+#define ROSE_SIMD_FUNC
+#else
+#define ROSE_SIMD_FUNC static __inline__
+#endif
+
+#include <stddef.h>
 
 /*
 The suffix implies the data type.
 By default, the data type is float.
 __SIMDi is for the integer.
 __SIMDd is for the double.
+
+_SIMD_VF_ps, _SIMD_VF_pd and _SIMD_VF_epi32 are the number of elements in one SIMD operand, which
+the generated loops use as their stride.  _SIMD_ALIGN is the alignment, in bytes, required by the
+aligned load and store functions.
 */
 
 #ifdef  USE_SSE
-// By default we support SSE2, and turn on the -msse2 GCC compiler flag 
+// By default we support SSE2, and turn on the -msse2 GCC compiler flag
 #include <emmintrin.h>
-typedef  __m128   __SIMD; 
-typedef  __m128i  __SIMDi; 
-typedef  __m128d  __SIMDd; 
+#ifdef __SSE4_1__
+#include <smmintrin.h>
+#endif
+typedef  __m128   __SIMD;
+typedef  __m128i  __SIMDi;
+typedef  __m128d  __SIMDd;
+#define _SIMD_VF_ps     4
+#define _SIMD_VF_pd     2
+#define _SIMD_VF_epi32  4
+#define _SIMD_ALIGN    16
 
-#elif defined USE_AVX
-#include <avxintrin.h>
-typedef  __m256   __SIMD; 
-typedef  __m256i  __SIMDi; 
-typedef  __m256d  __SIMDd; 
+#elif defined USE_AVX2
+#include <immintrin.h>
+typedef  __m256   __SIMD;
+typedef  __m256i  __SIMDi;
+typedef  __m256d  __SIMDd;
+#define _SIMD_VF_ps     8
+#define _SIMD_VF_pd     4
+#define _SIMD_VF_epi32  8
+#define _SIMD_ALIGN    32
 
 #elif defined USE_IBM
-typedef  vector float   __SIMD; 
-typedef  vector int     __SIMDi; 
-typedef  vector double  __SIMDd; 
+typedef  vector float   __SIMD;
+typedef  vector int     __SIMDi;
+typedef  vector double  __SIMDd;
+#define _SIMD_VF_ps     4
+#define _SIMD_VF_pd     2
+#define _SIMD_VF_epi32  4
+#define _SIMD_ALIGN    16
 
 #endif
 
+// True if the address p can be used by the aligned load and store functions.
+#define _SIMD_is_aligned(p) ((((size_t)(p)) & (_SIMD_ALIGN - 1)) == 0)
+
 /*
 The suffix name of each function is decided by the data type of operands.
 
 _ps means "packed single-precision"
 _pd means "packed double-precision"
-_epi32 is for "packed integer" 
+_epi32 is for "packed integer"
+
+Addition:        a = b + c      ==> a = _SIMD_add_ps(b,c)
+subtraction:     a = b - c      ==> a = _SIMD_sub_ps(b,c)
+multiplication:  a = b * c      ==> a = _SIMD_mul_ps(b,c)
+division:        a = b / c      ==> a = _SIMD_div_ps(b,c)   (integer is not supported for division)
+multiply-add:    a = b * c + d  ==> a = _SIMD_madd_ps(b,c,d)
+multiply-sub:    a = b * c - d  ==> a = _SIMD_msub_ps(b,c,d)
+
+The comparison functions (cmplt, cmple, cmpgt, cmpge, cmpeq, cmpne) return a mask operand whose
+elements have all bits set where the comparison holds and all bits clear elsewhere.  The masks are
+combined with and, or, andnot (~a & b) and not.  blend(a,b,mask) selects the elements of b where the
+mask is set and the elements of a elsewhere; it implements the if-conversion of conditional
+assignments.
+
+The reduce functions return the sum or the product of the elements of an operand.
+
+Only the arithmetic functions are mapped to AltiVec (USE_IBM).
 */
 
-#ifdef __cplusplus
-extern "C" {
+#ifdef  USE_SSE
+
+ROSE_SIMD_FUNC __SIMD  _SIMD_splats_ps(float f)      { return _mm_set1_ps(f); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_splats_pd(double f)     { return _mm_set1_pd(f); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_splats_epi32(int i)     { return _mm_set1_epi32(i); }
+
+ROSE_SIMD_FUNC __SIMD  _SIMD_load_ps(const float* p)     { return _mm_load_ps(p); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_load_pd(const double* p)    { return _mm_load_pd(p); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_load_epi32(const int* p)    { return _mm_load_si128((const __m128i*)p); }
+ROSE_SIMD_FUNC __SIMD  _SIMD_loadu_ps(const float* p)    { return _mm_loadu_ps(p); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_loadu_pd(const double* p)   { return _mm_loadu_pd(p); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_loadu_epi32(const int* p)   { return _mm_loadu_si128((const __m128i*)p); }
+
+ROSE_SIMD_FUNC void _SIMD_store_ps(float* p, __SIMD a)     { _mm_store_ps(p,a); }
+ROSE_SIMD_FUNC void _SIMD_store_pd(double* p, __SIMDd a)   { _mm_store_pd(p,a); }
+ROSE_SIMD_FUNC void _SIMD_store_epi32(int* p, __SIMDi a)   { _mm_store_si128((__m128i*)p,a); }
+ROSE_SIMD_FUNC void _SIMD_storeu_ps(float* p, __SIMD a)    { _mm_storeu_ps(p,a); }
+ROSE_SIMD_FUNC void _SIMD_storeu_pd(double* p, __SIMDd a)  { _mm_storeu_pd(p,a); }
+ROSE_SIMD_FUNC void _SIMD_storeu_epi32(int* p, __SIMDi a)  { _mm_storeu_si128((__m128i*)p,a); }
+
+ROSE_SIMD_FUNC __SIMD  _SIMD_add_ps(__SIMD a, __SIMD b)       { return _mm_add_ps(a,b); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_add_pd(__SIMDd a, __SIMDd b)     { return _mm_add_pd(a,b); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_add_epi32(__SIMDi a, __SIMDi b)  { return _mm_add_epi32(a,b); }
+ROSE_SIMD_FUNC __SIMD  _SIMD_sub_ps(__SIMD a, __SIMD b)       { return _mm_sub_ps(a,b); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_sub_pd(__SIMDd a, __SIMDd b)     { return _mm_sub_pd(a,b); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_sub_epi32(__SIMDi a, __SIMDi b)  { return _mm_sub_epi32(a,b); }
+ROSE_SIMD_FUNC __SIMD  _SIMD_mul_ps(__SIMD a, __SIMD b)       { return _mm_mul_ps(a,b); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_mul_pd(__SIMDd a, __SIMDd b)     { return _mm_mul_pd(a,b); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_mul_epi32(__SIMDi a, __SIMDi b)
+{
+#ifdef __SSE4_1__  // modern CPU - use SSE 4.1
+    return _mm_mullo_epi32(a, b);
+#else               // old CPU - use SSE 2
+    __m128i tmp1 = _mm_mul_epu32(a,b); /* mul 2,0*/
+    __m128i tmp2 = _mm_mul_epu32( _mm_srli_si128(a,4), _mm_srli_si128(b,4)); /* mul 3,1 */
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(tmp1, _MM_SHUFFLE (0,0,2,0)), _mm_shuffle_epi32(tmp2, _MM_SHUFFLE (0,0,2,0))); /* shuffle results to [63..0] and pack */
 #endif
-// Addition:  a = b + c  ==> a = _SIMD_add_ps(b,c)
-extern __SIMD  _SIMD_add_ps(__SIMD, __SIMD);
-extern __SIMDd _SIMD_add_pd(__SIMDd, __SIMDd);
-extern __SIMDi _SIMD_add_epi32(__SIMDi, __SIMDi);
-
-// subtraction:  a = b - c  ==> a = _SIMD_sub_ps(b,c)
-extern __SIMD  _SIMD_sub_ps(__SIMD, __SIMD);
-extern __SIMDd _SIMD_sub_pd(__SIMDd, __SIMDd);
-extern __SIMDi _SIMD_sub_epi32(__SIMDi, __SIMDi);
-
-// multiplication:  a = b * c  ==> a = _SIMD_mul_ps(b,c)
-extern __SIMD  _SIMD_mul_ps(__SIMD, __SIMD);
-extern __SIMDd _SIMD_mul_pd(__SIMDd, __SIMDd);
-extern __SIMDi _SIMD_mul_epi32(__SIMDi, __SIMDi);
-
-/* 
-  ivision:  a = b / c  ==> a = _SIMD_div_ps(b,c)
-  Integer is not supported for division.
-*/
-extern __SIMD  _SIMD_div_ps(__SIMD, __SIMD);
-extern __SIMDd _SIMD_div_pd(__SIMDd, __SIMDd);
+}
+ROSE_SIMD_FUNC __SIMD  _SIMD_div_ps(__SIMD a, __SIMD b)       { return _mm_div_ps(a,b); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_div_pd(__SIMDd a, __SIMDd b)     { return _mm_div_pd(a,b); }
+
+ROSE_SIMD_FUNC __SIMD  _SIMD_cmplt_ps(__SIMD a, __SIMD b)     { return _mm_cmplt_ps(a,b); }
+ROSE_SIMD_FUNC __SIMD  _SIMD_cmple_ps(__SIMD a, __SIMD b)     { return _mm_cmple_ps(a,b); }
+ROSE_SIMD_FUNC __SIMD  _SIMD_cmpgt_ps(__SIMD a, __SIMD b)     { return _mm_cmpgt_ps(a,b); }
+ROSE_SIMD_FUNC __SIMD  _SIMD_cmpge_ps(__SIMD a, __SIMD b)     { return _mm_cmpge_ps(a,b); }
+ROSE_SIMD_FUNC __SIMD  _SIMD_cmpeq_ps(__SIMD a, __SIMD b)     { return _mm_cmpeq_ps(a,b); }
+ROSE_SIMD_FUNC __SIMD  _SIMD_cmpne_ps(__SIMD a, __SIMD b)     { return _mm_cmpneq_ps(a,b); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_cmplt_pd(__SIMDd a, __SIMDd b)   { return _mm_cmplt_pd(a,b); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_cmple_pd(__SIMDd a, __SIMDd b)   { return _mm_cmple_pd(a,b); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_cmpgt_pd(__SIMDd a, __SIMDd b)   { return _mm_cmpgt_pd(a,b); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_cmpge_pd(__SIMDd a, __SIMDd b)   { return _mm_cmpge_pd(a,b); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_cmpeq_pd(__SIMDd a, __SIMDd b)   { return _mm_cmpeq_pd(a,b); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_cmpne_pd(__SIMDd a, __SIMDd b)   { return _mm_cmpneq_pd(a,b); }
+
+ROSE_SIMD_FUNC __SIMD  _SIMD_and_ps(__SIMD a, __SIMD b)       { return _mm_and_ps(a,b); }
+ROSE_SIMD_FUNC __SIMD  _SIMD_or_ps(__SIMD a, __SIMD b)        { return _mm_or_ps(a,b); }
+ROSE_SIMD_FUNC __SIMD  _SIMD_andnot_ps(__SIMD a, __SIMD b)    { return _mm_andnot_ps(a,b); }
+ROSE_SIMD_FUNC __SIMD  _SIMD_not_ps(__SIMD a)                 { return _mm_xor_ps(a,_mm_castsi128_ps(_mm_set1_epi32(-1))); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_and_pd(__SIMDd a, __SIMDd b)     { return _mm_and_pd(a,b); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_or_pd(__SIMDd a, __SIMDd b)      { return _mm_or_pd(a,b); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_andnot_pd(__SIMDd a, __SIMDd b)  { return _mm_andnot_pd(a,b); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_not_pd(__SIMDd a)                { return _mm_xor_pd(a,_mm_castsi128_pd(_mm_set1_epi32(-1))); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_and_epi32(__SIMDi a, __SIMDi b)     { return _mm_and_si128(a,b); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_or_epi32(__SIMDi a, __SIMDi b)      { return _mm_or_si128(a,b); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_andnot_epi32(__SIMDi a, __SIMDi b)  { return _mm_andnot_si128(a,b); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_not_epi32(__SIMDi a)                { return _mm_xor_si128(a,_mm_set1_epi32(-1)); }
 
-// multiply-add:  a = b * c + d  ==> a = _SIMD_madd_ps(b,c,d)
-extern __SIMD  _SIMD_madd_ps(__SIMD, __SIMD, __SIMD);
-extern __SIMDd _SIMD_madd_pd(__SIMDd, __SIMDd, __SIMDd);
-extern __SIMDi _SIMD_madd_epi32(__SIMDi, __SIMDi, __SIMDi);
+ROSE_SIMD_FUNC __SIMDi _SIMD_cmplt_epi32(__SIMDi a, __SIMDi b)   { return _mm_cmplt_epi32(a,b); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_cmple_epi32(__SIMDi a, __SIMDi b)   { return _SIMD_not_epi32(_mm_cmpgt_epi32(a,b)); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_cmpgt_epi32(__SIMDi a, __SIMDi b)   { return _mm_cmpgt_epi32(a,b); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_cmpge_epi32(__SIMDi a, __SIMDi b)   { return _SIMD_not_epi32(_mm_cmplt_epi32(a,b)); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_cmpeq_epi32(__SIMDi a, __SIMDi b)   { return _mm_cmpeq_epi32(a,b); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_cmpne_epi32(__SIMDi a, __SIMDi b)   { return _SIMD_not_epi32(_mm_cmpeq_epi32(a,b)); }
 
-// multiply-sub:  a = b * c - d  ==> a = _SIMD_msub_ps(b,c,d)
-extern __SIMD  _SIMD_msub_ps(__SIMD, __SIMD, __SIMD);
-extern __SIMDd _SIMD_msub_pd(__SIMDd, __SIMDd, __SIMDd);
-extern __SIMDi _SIMD_msub_epi32(__SIMDi, __SIMDi, __SIMDi);
+ROSE_SIMD_FUNC __SIMD  _SIMD_blend_ps(__SIMD a, __SIMD b, __SIMD mask)
+{ return _mm_or_ps(_mm_and_ps(mask,b), _mm_andnot_ps(mask,a)); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_blend_pd(__SIMDd a, __SIMDd b, __SIMDd mask)
+{ return _mm_or_pd(_mm_and_pd(mask,b), _mm_andnot_pd(mask,a)); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_blend_epi32(__SIMDi a, __SIMDi b, __SIMDi mask)
+{ return _mm_or_si128(_mm_and_si128(mask,b), _mm_andnot_si128(mask,a)); }
 
-// Sets all values packed in the SIMD operand to the same value.
-extern __SIMD  _SIMD_splats_ps(float);
-extern __SIMDd  _SIMD_splats_pd(double);
-extern __SIMDi  _SIMD_splats_epi32(int);
+#elif defined USE_AVX2
 
-#ifdef __cplusplus
+ROSE_SIMD_FUNC __SIMD  _SIMD_splats_ps(float f)      { return _mm256_set1_ps(f); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_splats_pd(double f)     { return _mm256_set1_pd(f); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_splats_epi32(int i)     { return _mm256_set1_epi32(i); }
+
+ROSE_SIMD_FUNC __SIMD  _SIMD_load_ps(const float* p)     { return _mm256_load_ps(p); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_load_pd(const double* p)    { return _mm256_load_pd(p); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_load_epi32(const int* p)    { return _mm256_load_si256((const __m256i*)p); }
+ROSE_SIMD_FUNC __SIMD  _SIMD_loadu_ps(const float* p)    { return _mm256_loadu_ps(p); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_loadu_pd(const double* p)   { return _mm256_loadu_pd(p); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_loadu_epi32(const int* p)   { return _mm256_loadu_si256((const __m256i*)p); }
+
+ROSE_SIMD_FUNC void _SIMD_store_ps(float* p, __SIMD a)     { _mm256_store_ps(p,a); }
+ROSE_SIMD_FUNC void _SIMD_store_pd(double* p, __SIMDd a)   { _mm256_store_pd(p,a); }
+ROSE_SIMD_FUNC void _SIMD_store_epi32(int* p, __SIMDi a)   { _mm256_store_si256((__m256i*)p,a); }
+ROSE_SIMD_FUNC void _SIMD_storeu_ps(float* p, __SIMD a)    { _mm256_storeu_ps(p,a); }
+ROSE_SIMD_FUNC void _SIMD_storeu_pd(double* p, __SIMDd a)  { _mm256_storeu_pd(p,a); }
+ROSE_SIMD_FUNC void _SIMD_storeu_epi32(int* p, __SIMDi a)  { _mm256_storeu_si256((__m256i*)p,a); }
+
+ROSE_SIMD_FUNC __SIMD  _SIMD_add_ps(__SIMD a, __SIMD b)       { return _mm256_add_ps(a,b); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_add_pd(__SIMDd a, __SIMDd b)     { return _mm256_add_pd(a,b); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_add_epi32(__SIMDi a, __SIMDi b)  { return _mm256_add_epi32(a,b); }
+ROSE_SIMD_FUNC __SIMD  _SIMD_sub_ps(__SIMD a, __SIMD b)       { return _mm256_sub_ps(a,b); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_sub_pd(__SIMDd a, __SIMDd b)     { return _mm256_sub_pd(a,b); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_sub_epi32(__SIMDi a, __SIMDi b)  { return _mm256_sub_epi32(a,b); }
+ROSE_SIMD_FUNC __SIMD  _SIMD_mul_ps(__SIMD a, __SIMD b)       { return _mm256_mul_ps(a,b); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_mul_pd(__SIMDd a, __SIMDd b)     { return _mm256_mul_pd(a,b); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_mul_epi32(__SIMDi a, __SIMDi b)  { return _mm256_mullo_epi32(a,b); }
+ROSE_SIMD_FUNC __SIMD  _SIMD_div_ps(__SIMD a, __SIMD b)       { return _mm256_div_ps(a,b); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_div_pd(__SIMDd a, __SIMDd b)     { return _mm256_div_pd(a,b); }
+
+ROSE_SIMD_FUNC __SIMD  _SIMD_cmplt_ps(__SIMD a, __SIMD b)     { return _mm256_cmp_ps(a,b,_CMP_LT_OQ); }
+ROSE_SIMD_FUNC __SIMD  _SIMD_cmple_ps(__SIMD a, __SIMD b)     { return _mm256_cmp_ps(a,b,_CMP_LE_OQ); }
+ROSE_SIMD_FUNC __SIMD  _SIMD_cmpgt_ps(__SIMD a, __SIMD b)     { return _mm256_cmp_ps(a,b,_CMP_GT_OQ); }
+ROSE_SIMD_FUNC __SIMD  _SIMD_cmpge_ps(__SIMD a, __SIMD b)     { return _mm256_cmp_ps(a,b,_CMP_GE_OQ); }
+ROSE_SIMD_FUNC __SIMD  _SIMD_cmpeq_ps(__SIMD a, __SIMD b)     { return _mm256_cmp_ps(a,b,_CMP_EQ_OQ); }
+ROSE_SIMD_FUNC __SIMD  _SIMD_cmpne_ps(__SIMD a, __SIMD b)     { return _mm256_cmp_ps(a,b,_CMP_NEQ_UQ); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_cmplt_pd(__SIMDd a, __SIMDd b)   { return _mm256_cmp_pd(a,b,_CMP_LT_OQ); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_cmple_pd(__SIMDd a, __SIMDd b)   { return _mm256_cmp_pd(a,b,_CMP_LE_OQ); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_cmpgt_pd(__SIMDd a, __SIMDd b)   { return _mm256_cmp_pd(a,b,_CMP_GT_OQ); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_cmpge_pd(__SIMDd a, __SIMDd b)   { return _mm256_cmp_pd(a,b,_CMP_GE_OQ); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_cmpeq_pd(__SIMDd a, __SIMDd b)   { return _mm256_cmp_pd(a,b,_CMP_EQ_OQ); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_cmpne_pd(__SIMDd a, __SIMDd b)   { return _mm256_cmp_pd(a,b,_CMP_NEQ_UQ); }
+
+ROSE_SIMD_FUNC __SIMD  _SIMD_and_ps(__SIMD a, __SIMD b)       { return _mm256_and_ps(a,b); }
+ROSE_SIMD_FUNC __SIMD  _SIMD_or_ps(__SIMD a, __SIMD b)        { return _mm256_or_ps(a,b); }
+ROSE_SIMD_FUNC __SIMD  _SIMD_andnot_ps(__SIMD a, __SIMD b)    { return _mm256_andnot_ps(a,b); }
+ROSE_SIMD_FUNC __SIMD  _SIMD_not_ps(__SIMD a)                 { return _mm256_xor_ps(a,_mm256_castsi256_ps(_mm256_set1_epi32(-1))); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_and_pd(__SIMDd a, __SIMDd b)     { return _mm256_and_pd(a,b); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_or_pd(__SIMDd a, __SIMDd b)      { return _mm256_or_pd(a,b); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_andnot_pd(__SIMDd a, __SIMDd b)  { return _mm256_andnot_pd(a,b); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_not_pd(__SIMDd a)                { return _mm256_xor_pd(a,_mm256_castsi256_pd(_mm256_set1_epi32(-1))); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_and_epi32(__SIMDi a, __SIMDi b)     { return _mm256_and_si256(a,b); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_or_epi32(__SIMDi a, __SIMDi b)      { return _mm256_or_si256(a,b); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_andnot_epi32(__SIMDi a, __SIMDi b)  { return _mm256_andnot_si256(a,b); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_not_epi32(__SIMDi a)                { return _mm256_xor_si256(a,_mm256_set1_epi32(-1)); }
+
+ROSE_SIMD_FUNC __SIMDi _SIMD_cmplt_epi32(__SIMDi a, __SIMDi b)   { return _mm256_cmpgt_epi32(b,a); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_cmple_epi32(__SIMDi a, __SIMDi b)   { return _SIMD_not_epi32(_mm256_cmpgt_epi32(a,b)); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_cmpgt_epi32(__SIMDi a, __SIMDi b)   { return _mm256_cmpgt_epi32(a,b); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_cmpge_epi32(__SIMDi a, __SIMDi b)   { return _SIMD_not_epi32(_mm256_cmpgt_epi32(b,a)); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_cmpeq_epi32(__SIMDi a, __SIMDi b)   { return _mm256_cmpeq_epi32(a,b); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_cmpne_epi32(__SIMDi a, __SIMDi b)   { return _SIMD_not_epi32(_mm256_cmpeq_epi32(a,b)); }
+
+ROSE_SIMD_FUNC __SIMD  _SIMD_blend_ps(__SIMD a, __SIMD b, __SIMD mask)       { return _mm256_blendv_ps(a,b,mask); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_blend_pd(__SIMDd a, __SIMDd b, __SIMDd mask)    { return _mm256_blendv_pd(a,b,mask); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_blend_epi32(__SIMDi a, __SIMDi b, __SIMDi mask) { return _mm256_blendv_epi8(a,b,mask); }
+
+#elif defined USE_IBM
+
+ROSE_SIMD_FUNC __SIMD  _SIMD_splats_ps(float f)      { return vec_splats(f); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_splats_pd(double f)     { return vec_splats(f); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_splats_epi32(int i)     { return vec_splats(i); }
+
+ROSE_SIMD_FUNC __SIMD  _SIMD_add_ps(__SIMD a, __SIMD b)       { return vec_add(a,b); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_add_pd(__SIMDd a, __SIMDd b)     { return vec_add(a,b); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_add_epi32(__SIMDi a, __SIMDi b)  { return vec_add(a,b); }
+ROSE_SIMD_FUNC __SIMD  _SIMD_sub_ps(__SIMD a, __SIMD b)       { return vec_sub(a,b); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_sub_pd(__SIMDd a, __SIMDd b)     { return vec_sub(a,b); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_sub_epi32(__SIMDi a, __SIMDi b)  { return vec_sub(a,b); }
+ROSE_SIMD_FUNC __SIMD  _SIMD_mul_ps(__SIMD a, __SIMD b)       { return vec_mul(a,b); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_mul_pd(__SIMDd a, __SIMDd b)     { return vec_mul(a,b); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_mul_epi32(__SIMDi a, __SIMDi b)  { return vec_mul(a,b); }
+ROSE_SIMD_FUNC __SIMD  _SIMD_div_ps(__SIMD a, __SIMD b)       { return vec_div(a,b); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_div_pd(__SIMDd a, __SIMDd b)     { return vec_div(a,b); }
+
+#endif
+
+ROSE_SIMD_FUNC __SIMD  _SIMD_madd_ps(__SIMD a, __SIMD b, __SIMD c)        { return _SIMD_add_ps(_SIMD_mul_ps(a,b),c); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_madd_pd(__SIMDd a, __SIMDd b, __SIMDd c)     { return _SIMD_add_pd(_SIMD_mul_pd(a,b),c); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_madd_epi32(__SIMDi a, __SIMDi b, __SIMDi c)  { return _SIMD_add_epi32(_SIMD_mul_epi32(a,b),c); }
+ROSE_SIMD_FUNC __SIMD  _SIMD_msub_ps(__SIMD a, __SIMD b, __SIMD c)        { return _SIMD_sub_ps(_SIMD_mul_ps(a,b),c); }
+ROSE_SIMD_FUNC __SIMDd _SIMD_msub_pd(__SIMDd a, __SIMDd b, __SIMDd c)     { return _SIMD_sub_pd(_SIMD_mul_pd(a,b),c); }
+ROSE_SIMD_FUNC __SIMDi _SIMD_msub_epi32(__SIMDi a, __SIMDi b, __SIMDi c)  { return _SIMD_sub_epi32(_SIMD_mul_epi32(a,b),c); }
+
+#ifndef USE_IBM
+/*
+  The reductions are evaluated once per vectorized loop, after the vector loop.  They go through memory
+  to stay independent of the operand width.
+*/
+ROSE_SIMD_FUNC float _SIMD_reduce_add_ps(__SIMD a)
+{
+  float e[_SIMD_VF_ps]; float r = 0; int i;
+  _SIMD_storeu_ps(e,a);
+  for (i = 0; i < _SIMD_VF_ps; i++) r += e[i];
+  return r;
+}
+ROSE_SIMD_FUNC double _SIMD_reduce_add_pd(__SIMDd a)
+{
+  double e[_SIMD_VF_pd]; double r = 0; int i;
+  _SIMD_storeu_pd(e,a);
+  for (i = 0; i < _SIMD_VF_pd; i++) r += e[i];
+  return r;
+}
+ROSE_SIMD_FUNC int _SIMD_reduce_add_epi32(__SIMDi a)
+{
+  int e[_SIMD_VF_epi32]; int r = 0; int i;
+  _SIMD_storeu_epi32(e,a);
+  for (i = 0; i < _SIMD_VF_epi32; i++) r += e[i];
+  return r;
+}
+ROSE_SIMD_FUNC float _SIMD_reduce_mul_ps(__SIMD a)
+{
+  float e[_SIMD_VF_ps]; float r = 1; int i;
+  _SIMD_storeu_ps(e,a);
+  for (i = 0; i < _SIMD_VF_ps; i++) r *= e[i];
+  return r;
+}
+ROSE_SIMD_FUNC double _SIMD_reduce_mul_pd(__SIMDd a)
+{
+  double e[_SIMD_VF_pd]; double r = 1; int i;
+  _SIMD_storeu_pd(e,a);
+  for (i = 0; i < _SIMD_VF_pd; i++) r *= e[i];
+  return r;
+}
+ROSE_SIMD_FUNC int _SIMD_reduce_mul_epi32(__SIMDi a)
+{
+  int e[_SIMD_VF_epi32]; int r = 1; int i;
+  _SIMD_storeu_epi32(e,a);
+  for (i = 0; i < _SIMD_VF_epi32; i++) r *= e[i];
+  return r;
 }
 #endif
+
 #endif  // LIB_SIMD_H
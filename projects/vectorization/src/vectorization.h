@@ -3,6 +3,7 @@
 
 #include "rose.h"
 #include "sageBuilder.h"
+#include "SIMDAnalysis.h"
 #include <vector>
 #include <iostream>
 #include <fstream>
@@ -26,6 +27,10 @@ namespace SIMDVectorization
 //  repalce the multiply-accumulate operations to the function call.  The second argument is the name of function.
   void generateMultiplyAccumulateFunctionCall(SgBinaryOp*,SgName);
 
+//  Translate a loop accepted by SIMDAnalysis::isVectorizableLoop() into an alignment peeling loop, a vector loop with
+//  the SIMD width as stride, and a remainder loop.
+  void vectorizeLoop(SgForStatement*, const SIMDAnalysis::VectorizableLoopInfo&);
+
 //  Insert SIMD data types, __SIMD, __SIMDi and __SIMDd, into AST.  
   void insertSIMDDataType(SgGlobal*);
 //  get the mapped SIMD data type from the scalar data type
@@ -0,0 +1,159 @@
+/*
+  Correctness and speedup test of the vectorized TSVC kernels.
+
+  The driver is linked with the translated kernels (rose_tsvcKernels.c) and with the
+  original kernels compiled with -DTSVC_REFERENCE.  For each kernel, it runs both
+  versions on the same input, compares all the arrays and the reduction results, and
+  then times both versions.
+
+  Usage: tsvcDriver [repetitions]
+  Exits with the number of kernels whose results differ.
+
+  The input values are small multiples of powers of two, so that the sums and products
+  computed by the reductions are exact in any order of evaluation.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sys/time.h>
+#include "tsvcKernels.h"
+
+float a[LEN], b[LEN], c[LEN], d[LEN], e[LEN];
+float aa[LEN2][LEN2], bb[LEN2][LEN2], cc[LEN2][LEN2];
+double da[LEN], db[LEN], dc[LEN], dd[LEN];
+int ia[LEN], ib[LEN], ic[LEN];
+float x = 1.5f;
+float fresult;
+double dresult;
+int iresult;
+
+static struct {
+  float a[LEN], b[LEN], c[LEN], d[LEN], e[LEN];
+  float aa[LEN2][LEN2];
+  double da[LEN];
+  int ia[LEN];
+  float fresult;
+  double dresult;
+  int iresult;
+} expected;
+
+static void init(void)
+{
+  static const float period3[3] = { 2.f, .5f, -1.f };
+  int i, j;
+  for (i = 0; i < LEN; i++) {
+    a[i] = period3[i % 3];
+    b[i] = (float)(i % 7 - 3);
+    c[i] = (i % 5 - 2) * .25f;
+    d[i] = (i % 11) * .125f - .5f;
+    e[i] = (i % 13 - 6) * .5f;
+    da[i] = i % 3 - 1;
+    db[i] = (i % 7 - 3) * .5;
+    dc[i] = i % 5 - 2;
+    dd[i] = (i % 11) * .25;
+    ia[i] = 0;
+    ib[i] = i % 9 - 4;
+    ic[i] = i % 5 - 2;
+  }
+  for (j = 0; j < LEN2; j++) {
+    for (i = 0; i < LEN2; i++) {
+      aa[j][i] = (float)((i + j) % 7 - 3);
+      bb[j][i] = ((i * j) % 5) * .5f;
+      cc[j][i] = (float)(j % 3 - 1);
+    }
+  }
+  fresult = 0.f;
+  dresult = 0.;
+  iresult = 0;
+}
+
+static void save(void)
+{
+  memcpy(expected.a, a, sizeof(a));
+  memcpy(expected.b, b, sizeof(b));
+  memcpy(expected.c, c, sizeof(c));
+  memcpy(expected.d, d, sizeof(d));
+  memcpy(expected.e, e, sizeof(e));
+  memcpy(expected.aa, aa, sizeof(aa));
+  memcpy(expected.da, da, sizeof(da));
+  memcpy(expected.ia, ia, sizeof(ia));
+  expected.fresult = fresult;
+  expected.dresult = dresult;
+  expected.iresult = iresult;
+}
+
+static int same(double x, double y)
+{
+  return fabs(x - y) <= 1e-6 * (fabs(x) + fabs(y)) || x == y;
+}
+
+static int compare(const char* name)
+{
+  int i, j, errors = 0;
+#define CHECK(X, Y, WHAT) \
+  if (!same((X), (Y)) && errors++ < 5) \
+    fprintf(stderr, "%s: %s expected %g, got %g\n", name, WHAT, (double)(X), (double)(Y));
+  for (i = 0; i < LEN; i++) {
+    CHECK(expected.a[i], a[i], "a");
+    CHECK(expected.b[i], b[i], "b");
+    CHECK(expected.c[i], c[i], "c");
+    CHECK(expected.d[i], d[i], "d");
+    CHECK(expected.e[i], e[i], "e");
+    CHECK(expected.da[i], da[i], "da");
+    CHECK(expected.ia[i], ia[i], "ia");
+  }
+  for (j = 0; j < LEN2; j++)
+    for (i = 0; i < LEN2; i++)
+      CHECK(expected.aa[j][i], aa[j][i], "aa");
+  CHECK(expected.fresult, fresult, "fresult");
+  CHECK(expected.dresult, dresult, "dresult");
+  CHECK(expected.iresult, iresult, "iresult");
+#undef CHECK
+  return errors;
+}
+
+static double seconds(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + 1e-6 * tv.tv_usec;
+}
+
+static double timeKernel(void (*kernel)(void), int repetitions)
+{
+  double start;
+  int r;
+  init();
+  start = seconds();
+  for (r = 0; r < repetitions; r++)
+    kernel();
+  return seconds() - start;
+}
+
+int main(int argc, char* argv[])
+{
+  int repetitions = argc > 1 ? atoi(argv[1]) : 1000;
+  int failures = 0;
+
+  printf("%-8s %12s %12s %8s\n", "kernel", "scalar (s)", "vector (s)", "speedup");
+#define RUN(name) \
+  { \
+    double scalarTime, vectorTime; \
+    int errors; \
+    init(); name##_ref(); save(); \
+    init(); name(); \
+    errors = compare(#name); \
+    failures += errors != 0; \
+    scalarTime = timeKernel(name##_ref, repetitions); \
+    vectorTime = timeKernel(name, repetitions); \
+    printf("%-8s %12.4f %12.4f %8.2f %s\n", #name, scalarTime, vectorTime, \
+           vectorTime > 0 ? scalarTime / vectorTime : 0., errors ? "FAILED" : ""); \
+  }
+  TSVC_KERNEL_LIST(RUN)
+#undef RUN
+
+  if (failures != 0)
+    printf("%d kernel(s) computed wrong results\n", failures);
+  return failures;
+}
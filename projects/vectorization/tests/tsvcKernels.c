@@ -0,0 +1,185 @@
+/*
+  Test vectorization of TSVC kernels.
+
+  The translated kernels are checked against the original kernels by tsvcDriver.c,
+  which also reports the speedup of each kernel.  s1221 and s211 carry dependences
+  that prevent their vectorization, and the parameters of vparam may alias; they must
+  be left as they are.  Makefile.am checks which kernels the translation vectorized.
+*/
+#include "tsvcKernels.h"
+
+/* linear dependence testing: no dependence */
+void KERNEL(s000)(void)
+{
+  for (int i = 0; i < LEN; i++)
+    a[i] = b[i] + 1.f;
+}
+
+/* loop carried anti dependence, which vectorization preserves */
+void KERNEL(s121)(void)
+{
+  for (int i = 0; i < LEN - 1; i++)
+    a[i] = a[i + 1] + b[i];
+}
+
+/* loop carried true dependence of distance 4 within a statement: not vectorized */
+void KERNEL(s1221)(void)
+{
+  for (int i = 4; i < LEN; i++)
+    b[i] = b[i - 4] + a[i];
+}
+
+/* loop carried true dependence from a later statement to an earlier one: not vectorized */
+void KERNEL(s211)(void)
+{
+  for (int i = 1; i < LEN - 1; i++) {
+    a[i] = b[i - 1] + c[i] * d[i];
+    b[i] = b[i + 1] - e[i] * d[i];
+  }
+}
+
+/* if-conversion */
+void KERNEL(s271)(void)
+{
+  for (int i = 0; i < LEN; i++)
+    if (b[i] > 0.f)
+      a[i] += b[i] * c[i];
+}
+
+/* if-conversion of several statements */
+void KERNEL(s272)(void)
+{
+  for (int i = 0; i < LEN; i++) {
+    if (e[i] >= x) {
+      a[i] += c[i] * d[i];
+      b[i] += c[i] * c[i];
+    }
+  }
+}
+
+/* if-conversion of a condition computed by the loop */
+void KERNEL(s273)(void)
+{
+  for (int i = 0; i < LEN; i++) {
+    a[i] += d[i] * e[i];
+    if (a[i] < 0.f)
+      b[i] += d[i] * e[i];
+    c[i] += a[i] * d[i];
+  }
+}
+
+/* if-conversion with an else branch */
+void KERNEL(s274)(void)
+{
+  for (int i = 0; i < LEN; i++) {
+    a[i] = c[i] + e[i] * d[i];
+    if (a[i] > 0.f)
+      b[i] = a[i] + b[i];
+    else
+      a[i] = d[i] * e[i];
+  }
+}
+
+/* sum reduction */
+void KERNEL(s311)(void)
+{
+  float sum = 0.f;
+  for (int i = 0; i < LEN; i++)
+    sum += a[i];
+  fresult = sum;
+}
+
+/* product reduction */
+void KERNEL(s312)(void)
+{
+  float prod = 1.f;
+  for (int i = 0; i < LEN; i++)
+    prod *= a[i];
+  fresult = prod;
+}
+
+/* conditional sum reduction */
+void KERNEL(s3111)(void)
+{
+  float sum = 0.f;
+  for (int i = 0; i < LEN; i++)
+    if (a[i] > 0.f)
+      sum += a[i];
+  fresult = sum;
+}
+
+/* dot product */
+void KERNEL(vdotr)(void)
+{
+  float dot = 0.f;
+  for (int i = 0; i < LEN; i++)
+    dot = dot + a[i] * b[i];
+  fresult = dot;
+}
+
+/* vector plus vector times vector */
+void KERNEL(vpvtv)(void)
+{
+  for (int i = 0; i < LEN; i++)
+    a[i] += b[i] * c[i];
+}
+
+/* vector times vector */
+void KERNEL(vtv)(void)
+{
+  for (int i = 0; i < LEN; i++)
+    a[i] *= b[i];
+}
+
+/* loop invariant scalar operand */
+void KERNEL(vbor)(void)
+{
+  for (int i = 0; i < LEN; i++)
+    a[i] = x * b[i] + c[i] * d[i] - x * e[i];
+}
+
+/* misaligned store: the peeling loop aligns a[i + 1] */
+void KERNEL(s1112)(void)
+{
+  for (int i = 0; i < LEN - 1; i++)
+    a[i + 1] = b[i] * c[i] + d[i];
+}
+
+/* two dimensional arrays: the inner loop is vectorized */
+void KERNEL(s2275)(void)
+{
+  for (int j = 0; j < LEN2; j++)
+    for (int i = 0; i < LEN2; i++)
+      aa[j][i] = aa[j][i] + bb[j][i] * cc[j][i];
+}
+
+/* double precision, with a reduction */
+void KERNEL(vdouble)(void)
+{
+  double sum = 0.;
+  for (int i = 0; i < LEN; i++) {
+    da[i] = db[i] * dc[i] - dd[i];
+    sum += da[i];
+  }
+  dresult = sum;
+}
+
+/* integer operands */
+void KERNEL(vint)(void)
+{
+  int sum = 0;
+  for (int i = 0; i < LEN; i++) {
+    ia[i] = ib[i] * ic[i] + 3;
+    if (ib[i] > ic[i])
+      sum += ia[i];
+  }
+  iresult = sum;
+}
+
+/* array parameters are pointers, which may refer to the same array: not vectorized.
+   Not timed by the driver, as it takes arguments. */
+void KERNEL(vparam)(float y[LEN], float z[LEN])
+{
+  for (int i = 0; i < LEN; i++)
+    y[i] = z[i] + 1.f;
+}
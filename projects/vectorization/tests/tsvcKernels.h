@@ -0,0 +1,41 @@
+/*
+  Declarations shared by the TSVC kernels and their test driver.
+
+  The kernels are taken from the Test Suite for Vectorizing Compilers
+  (Callahan, Dongarra and Levine; C version by Maleki, Gao, Garzaran, Wong and Padua).
+  They operate on global arrays, which the driver defines.
+*/
+#ifndef TSVC_KERNELS_H
+#define TSVC_KERNELS_H
+
+#define LEN 32000
+#define LEN2 256
+
+extern float a[LEN], b[LEN], c[LEN], d[LEN], e[LEN];
+extern float aa[LEN2][LEN2], bb[LEN2][LEN2], cc[LEN2][LEN2];
+extern double da[LEN], db[LEN], dc[LEN], dd[LEN];
+extern int ia[LEN], ib[LEN], ic[LEN];
+extern float x;
+extern float fresult;
+extern double dresult;
+extern int iresult;
+
+/*
+  The reference build of the kernels, which is not translated, adds the
+  suffix _ref to the name of each kernel.
+*/
+#ifdef TSVC_REFERENCE
+#define KERNEL(name) name##_ref
+#else
+#define KERNEL(name) name
+#endif
+
+#define TSVC_KERNEL_LIST(X) \
+  X(s000) X(s121) X(s1221) X(s211) X(s271) X(s272) X(s273) X(s274) \
+  X(s311) X(s312) X(s3111) X(vdotr) X(vpvtv) X(vtv) X(vbor) X(s1112) \
+  X(s2275) X(vdouble) X(vint)
+
+#define TSVC_DECLARE(name) void name(void); void name##_ref(void);
+TSVC_KERNEL_LIST(TSVC_DECLARE)
+
+#endif
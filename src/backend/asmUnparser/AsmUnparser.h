@@ -7,6 +7,7 @@
 #include "BinaryControlFlow.h"
 #include "BinaryFunctionCall.h"
 #include "Disassembler.h"
+#include "threadSupport.h"
 
 #ifndef __STDC_FORMAT_MACROS
 #define __STDC_FORMAT_MACROS
@@ -576,11 +577,15 @@ public:
         Disassembler *disassembler;
         AsmUnparser *unparser;
         bool unparser_allocated_here;
-        StaticDataDisassembler(): disassembler(NULL), unparser(NULL), unparser_allocated_here(false) {}
+        StaticDataDisassembler(): disassembler(NULL), unparser(NULL), unparser_allocated_here(false) {
+            RTS_mutex_init(&mutex, RTS_LAYER_ASM_UNPARSER_OBJ, NULL);
+        }
         ~StaticDataDisassembler() { reset(); }
         virtual void reset();
         virtual void init(Disassembler *disassembler, AsmUnparser *unparser=NULL);
         virtual bool operator()(bool enabled, const StaticDataArgs &args);
+    private:
+        RTS_mutex_t mutex;      /* Serializes use of the unparser when functions are unparsed in parallel. */
     };
 
     /** Update static data end address for skip/back reporting.  This callback should probably not be removed if skip/back
@@ -764,7 +769,7 @@ public:
      **************************************************************************************************************************/
 
     /** Constructor that intializes the "unparser" callback lists with some useful functors. */
-    AsmUnparser() {
+    AsmUnparser(): nthreads(1) {
         init();
     }
 
@@ -829,6 +834,28 @@ public:
      *  Returns true if the node was unparsed, false otherwise. */
     virtual bool unparse_one_node(std::ostream&, SgNode*);
 
+    /** Unparse a list of nodes.
+     *
+     *  This is the same as calling unparse_one_node() for each node in turn, and is how unparse() and the InterpBody callback
+     *  emit the top-level unparsable nodes (usually functions) when output is organized by AST.  If get_nthreads() is more
+     *  than one then the nodes are rendered in parallel (see set_nthreads()) but the output is the same.  Returns the number
+     *  of nodes. */
+    virtual size_t unparse_nodes(std::ostream&, const std::vector<SgNode*>&);
+
+    /** Number of threads used to unparse functions.
+     *
+     *  When output is organized by AST and the number of threads is more than one, unparse_nodes() hands the nodes to a pool
+     *  of threads.  Each thread renders one node at a time into its own reusable buffer using a private worker unparser (see
+     *  new_worker()), and a node's text is written to the output stream as soon as it and all the nodes before it have been
+     *  rendered. Therefore output appears incrementally and in the same order as when unparsing serially, and a node's
+     *  text is held in memory only until it can be written.  The callbacks in the callback lists are shared by all the threads and
+     *  must be safe to call concurrently.  The default is one thread. If ROSE was
+     *  configured without thread support then the nodes are always unparsed in the calling thread.
+     *  @{ */
+    void set_nthreads(size_t n) { nthreads = n>0 ? n : 1; }
+    size_t get_nthreads() const { return nthreads; }
+    /** @} */
+
     /** Unparse an object. These are called by unparse_one_node(), but might also be called by callbacks.
      *
      *  @{ */
@@ -906,6 +933,21 @@ protected:
             pre.clear();
             post.clear();
         }
+
+        /** Makes these lists contain the same callbacks as @p other.  The functors themselves are not copied. */
+        void assign(const CallbackLists &other) {
+            clear();
+            copy(other.unparse, unparse);
+            copy(other.pre, pre);
+            copy(other.post, post);
+        }
+
+    private:
+        static void copy(const ROSE_Callbacks::List<UnparserCallback> &src, ROSE_Callbacks::List<UnparserCallback> &dst) {
+            std::list<UnparserCallback*> cbs = src.callbacks();
+            for (std::list<UnparserCallback*>::iterator ci=cbs.begin(); ci!=cbs.end(); ++ci)
+                dst.append(*ci);
+        }
     };
 
     CallbackLists insn_callbacks;                       /**< Callbacks for instruction unparsing. */
@@ -942,6 +984,23 @@ protected:
     /** Initializes the callback lists.  This is invoked by the default constructor. */
     virtual void init();
 
+    /** Allocates an unparser for a worker thread.  When nodes are unparsed in parallel, unparse_nodes() calls this once per
+     *  thread and then copies this unparser's configuration and callback lists into the new unparser with init_worker().
+     *  Subclasses that override the unparse_*() methods should override this to allocate an object of the subclass. */
+    virtual AsmUnparser *new_worker() const { return new AsmUnparser; }
+
+    /** Copies this unparser's settings, maps, graphs, and callback lists into a worker unparser.  The worker's callback
+     *  lists refer to the same functors as this unparser's. */
+    virtual void init_worker(AsmUnparser *worker) const;
+
+    /* State shared by the threads of a parallel unparse_nodes(), and the per-thread start function. Defined in AsmUnparser.C */
+    struct ParallelUnparse;
+    struct ParallelWorker;
+    static void *parallel_unparse_main(void*);
+
+    /** Number of threads used by unparse_nodes(). See set_nthreads(). */
+    size_t nthreads;
+
     /** Control flow graph. If non-empty, then it is used for things like listing CFG predecessors of each basic block. */
     CFG cfg;
 
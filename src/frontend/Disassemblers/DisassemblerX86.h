@@ -20,6 +20,7 @@ public:
           rexR(false), rexX(false), rexB(false), sizeMustBe64Bit(false), operandSizeOverride(false), addressSizeOverride(false),
           lock(false), repeatPrefix(x86_repeat_none), modregrmByteSet(false), modregrmByte(0), modeField(0), rmField(0), 
           modrm(NULL), reg(NULL), isUnconditionalJump(false) {
+        clearRegisterCache();
         init(wordsize);
     }
 
@@ -32,6 +33,7 @@ public:
           lock(other.lock), repeatPrefix(other.repeatPrefix), modregrmByteSet(other.modregrmByteSet),
           modregrmByte(other.modregrmByte), modeField(other.modeField), rmField(other.rmField), modrm(other.modrm),
           reg(other.reg), isUnconditionalJump(other.isUnconditionalJump) {
+        clearRegisterCache();
     }
     
     virtual ~DisassemblerX86() {}
@@ -191,6 +193,14 @@ private:
      *  than one type. */
     SgAsmx86RegisterReferenceExpression *makeRegister(uint8_t fullRegisterNumber, RegisterMode, SgAsmType *registerType=NULL) const;
 
+    /** Returns the name of a register as it appears in the register dictionary. Throws an exception if the register number
+     *  is out of range for the mode. */
+    static std::string registerName(uint8_t fullRegisterNumber, RegisterMode);
+
+    /** Returns the descriptor for a register from the register dictionary, using the register cache when possible. Throws an
+     *  exception if the register dictionary has no such register. */
+    const RegisterDescriptor *lookupRegister(uint8_t fullRegisterNumber, RegisterMode) const;
+
     /* FIXME: documentation? */
     SgAsmx86RegisterReferenceExpression *makeRegisterEffective(uint8_t fullRegisterNumber) {
         return makeRegister(fullRegisterNumber, effectiveOperandMode());
@@ -368,10 +378,21 @@ private:
         segOverride = insn->get_segmentOverride();
     }
     
+    /** Discards all cached register descriptors. */
+    void clearRegisterCache() const {
+        regcache_dict = NULL;
+        for (size_t i=0; i<=x86_insnsize_64; ++i)
+            regcache_ip[i] = NULL;
+        for (size_t i=0; i<rmReturnNull; ++i) {
+            for (size_t j=0; j<16; ++j)
+                regcache[i][j] = NULL;
+        }
+    }
+
     /** Resets disassembler state to beginning of an instruction for disassembly. */
     void startInstruction(rose_addr_t start_va, const uint8_t *buf, size_t bufsz) {
         ip = start_va;
-        insnbuf = SgUnsignedCharList(buf, buf+bufsz);
+        insnbuf.assign(buf, buf+bufsz);         /* reuses the buffer's storage from the previous instruction */
         insnbufat = 0;
 
         /* Prefix flags */
@@ -393,6 +414,15 @@ private:
     /* Per-disassembler settings; see init() */
     X86InstructionSize insnSize;                /**< Default size of instructions, based on architecture; see init() */
 
+    /* Register descriptors indexed by register mode and register number.  Looking up a register by name in the dictionary
+     * means building the name and searching an std::map of strings, which is a large part of the cost of decoding an
+     * instruction since most instructions have at least one register operand.  Entries are filled in the first time each
+     * register is needed and all entries are discarded when the register dictionary changes. The entries point into the
+     * register dictionary. */
+    mutable const RegisterDictionary *regcache_dict;    /**< Dictionary from which the cached descriptors came */
+    mutable const RegisterDescriptor *regcache[rmReturnNull][16];
+    mutable const RegisterDescriptor *regcache_ip[x86_insnsize_64+1]; /**< Instruction pointer indexed by instruction size */
+
     /* Per-instruction settings; see startInstruction() */
     uint64_t ip;                                /**< Virtual address for start of instruction */
     SgUnsignedCharList insnbuf;                 /**< Buffer containing bytes of instruction */
@@ -47,6 +47,8 @@ class MangledNameMapTraversal : public ROSE_VisitTraversal
 #else
           // CH (4/13/2010): Use boost::hash<string> instead
           //typedef rose_hash::unordered_map<std::string, SgNode*, rose_hash::hash_string, rose_hash::eqstr_string> MangledNameMapType;
+       // The full mangled name is the key: a hash of it alone could silently merge unrelated
+       // IR nodes on a collision.
           typedef rose_hash::unordered_map<std::string, SgNode*> MangledNameMapType;
 #endif
        // The delete list is just a set
@@ -61,10 +63,9 @@ class MangledNameMapTraversal : public ROSE_VisitTraversal
        // Allow these containers to be built (empty) outside of this class and set by the visit function.
           MangledNameMapType & mangledNameMap;
           SetOfNodesType     & setOfNodesToDelete;
-          SetOfNodesType     setOfNodesPreviouslyVisited;
 
           void visit ( SgNode* node);
-          void addToMap ( std::string key, SgNode* node);
+          void addToMap ( const std::string & key, SgNode* node);
 
           static void displayMagledNameMap ( MangledNameMapType & mangledNameMap );
 
@@ -21,6 +21,17 @@ ROSEAttributesList *getPreprocessorDirectives( std::string fileName );
 
 void attachPreprocessingInfo(SgSourceFile *sageFile);
 
+// Support for -rose:lazy_commentsAndDirectives: deferPreprocessingInfo() records that the comments and 
+// CPP directives of a source file are to be attached on first use, and attachDeferredPreprocessingInfo()
+// attaches them to the source file containing the given node if that has not been done yet (returns
+// true if it did the attachment).
+void deferPreprocessingInfo(SgSourceFile *sageFile);
+bool attachDeferredPreprocessingInfo(SgNode *node);
+
+// Frees the comments and CPP directives of header files that are cached to lex each header file only once (see
+// AttachPreprocessingInfoTreeTrav::buildCommentAndCppDirectiveListForHeaderFile()).  Called when a SgProject is deleted.
+void clearHeaderFileAttributeListCache();
+
 // DQ (11/30/2008): Part of refactoring of code specific to Wave.
 void attachPreprocessingInfoUsingWave(SgSourceFile *sageFile);
 
@@ -161,6 +161,10 @@ class AttachPreprocessingInfoTreeTrav
        // DQ (11/30/2008): Refactored code to isolate this from the inherited attribute evaluation.
        // static ROSEAttributesList* buildCommentAndCppDirectiveList ( SgFile *currentFilePtr, std::map<std::string,ROSEAttributesList*>* mapOfAttributes, bool use_Wave );
           ROSEAttributesList* buildCommentAndCppDirectiveList ( bool use_Wave, std::string currentFilename );
+
+       // Same as buildCommentAndCppDirectiveList() but header files are lexed only once per process (the
+       // returned list is a copy of a cached list).
+          ROSEAttributesList* buildCommentAndCppDirectiveListForHeaderFile ( bool use_Wave, std::string currentFilename );
    };
 
 #endif
@@ -5,7 +5,7 @@
 #include <libdwarf.h>
 
 // Main function to read dwarf.
-// void build_dwarf_IR_nodes(Dwarf_Debug dbg, SgAsmInterpretation* asmInterpretation);
+// void build_dwarf_IR_nodes(Dwarf_Debug dbg, SgAsmInterpretation* asmInterpretation, bool lazy);
 
 void readDwarf ( SgAsmGenericFile* asmFile );
 
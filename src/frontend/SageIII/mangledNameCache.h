@@ -0,0 +1,130 @@
+#ifndef ROSE_MANGLED_NAME_CACHE_H
+#define ROSE_MANGLED_NAME_CACHE_H
+
+#include "threadSupport.h"
+
+#include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
+#include <string>
+#include <vector>
+
+class SgNode;
+
+/** Thread-safe cache of mangled names.
+ *
+ *  Mangled names are computed by the various get_mangled_name() methods and are needed over and over by the AST merge, the
+ *  unparser, the call graph and symbol table lookups.  Computing them is expensive, so they are cached per IR node.  This
+ *  class replaces the process-global std::map tables that used to be static data members of SgNode (globalMangledNameMap and
+ *  shortMangledNameCache):
+ *
+ *  <ul>
+ *    <li>The cache is split into shards, each protected by its own mutex, so that threads computing mangled names for
+ *        unrelated IR nodes do not contend for a single lock.</li>
+ *    <li>Each distinct mangled name is stored once (interned); IR nodes refer to it by handle.  Many IR nodes share the same
+ *        name (e.g., all the non-defining declarations of a function).</li>
+ *    <li>The cached name for an IR node can be invalidated explicitly when a transformation changes something the name
+ *        depends upon (its scope, its name, etc.) without throwing away the whole cache.</li>
+ *  </ul>
+ *
+ *  The short name table maps long mangled names to small integers so that names longer than a threshold can be replaced by
+ *  "L<id>R" (see SageInterface::addMangledNameToCache()).  Unlike the per-node names, the short name table is never cleared
+ *  because the same long name must map to the same short name across clears (function types depend on this). */
+class MangledNameCache {
+public:
+    /** Interned mangled name.  A handle remains valid until the next call to clear(). */
+    typedef const std::string *Handle;
+
+    /** Approximate memory used by the cache, in bytes and entries. */
+    struct MemoryUsage {
+        size_t nNodes;                  /**< Number of IR nodes having a cached name. */
+        size_t nNames;                  /**< Number of distinct interned names. */
+        size_t nShortNames;             /**< Number of entries in the short name table. */
+        size_t nodeBytes;               /**< Bytes used by the IR node to handle tables. */
+        size_t nameBytes;               /**< Bytes used by the interned names. */
+        size_t shortNameBytes;          /**< Bytes used by the short name table. */
+        size_t longNameChars;           /**< Total length of all names in the short name table. */
+
+        MemoryUsage()
+            : nNodes(0), nNames(0), nShortNames(0), nodeBytes(0), nameBytes(0), shortNameBytes(0), longNameChars(0) {}
+
+        /** Total number of bytes used by the cache. */
+        size_t total() const { return nodeBytes + nameBytes + shortNameBytes; }
+    };
+
+    MangledNameCache();
+    ~MangledNameCache();
+
+    /** The cache used by the get_mangled_name() methods. */
+    static MangledNameCache& global();
+
+    /** Returns the cached mangled name of an IR node, or NULL if the node has none. */
+    Handle lookup(const SgNode*) const;
+
+    /** Returns the cached mangled name of an IR node, or the empty string if the node has none. */
+    std::string get(const SgNode*) const;
+
+    /** Returns true if the IR node has a cached mangled name. */
+    bool exists(const SgNode *node) const { return lookup(node)!=NULL; }
+
+    /** Caches the mangled name of an IR node unless it already has one.  Returns the name cached for the node, which is the
+     *  previously cached name if there was one (like std::map::insert). */
+    Handle insert(const SgNode*, const std::string &mangledName);
+
+    /** Caches the mangled name of an IR node, replacing any previously cached name.  Returns the interned name. */
+    Handle replace(const SgNode*, const std::string &mangledName);
+
+    /** Removes the cached mangled name of an IR node.  This must be called when a transformation changes any property of
+     *  the node that contributes to its mangled name.  Returns true if the node had a cached name. */
+    bool invalidate(const SgNode*);
+
+    /** Removes all cached names (but not the short name table).  All handles become invalid, so this must not be called
+     *  while other threads are using the cache. */
+    void clear();
+
+    /** Number of IR nodes having a cached mangled name. */
+    size_t size() const;
+
+    /** Returns the unique identifier for a long mangled name, allocating a new one if necessary.  Identifiers are allocated
+     *  consecutively starting at zero in the order long names are first seen, as they were by the former
+     *  shortMangledNameCache, so the "L<id>R" names are unchanged. */
+    size_t shortNameId(const std::string &longName);
+
+    /** Returns the list of all cached IR nodes and their names.  This is intended for diagnostics. */
+    std::vector<std::pair<const SgNode*, std::string> > entries() const;
+
+    /** Returns the approximate memory used by the cache. */
+    MemoryUsage memoryUsage() const;
+
+private:
+    enum { NSHARDS = 64 };
+
+    typedef boost::unordered_map<const SgNode*, Handle> NodeNames;
+    typedef boost::unordered_set<std::string> InternedNames;
+    typedef boost::unordered_map<std::string, size_t> ShortNames;
+
+    /* Each shard holds the IR nodes whose address hashes to it and the interned names whose text hashes to it.  No thread
+     * ever holds more than one lock at a time. */
+    struct Shard {
+        mutable RTS_mutex_t mutex;
+        NodeNames nodeNames;
+        InternedNames internedNames;
+    };
+
+    static size_t shardOf(const SgNode*);
+    static size_t shardOf(const std::string&);
+
+    /* Not copyable */
+    MangledNameCache(const MangledNameCache&);
+    MangledNameCache& operator=(const MangledNameCache&);
+
+    Handle store(const SgNode*, const std::string &mangledName, bool replaceExisting);
+
+    Shard shards[NSHARDS];
+
+    /* The short name table is not sharded since its identifiers must be allocated from a single sequence.  It is only used
+     * for long names, so there is little contention for its lock. */
+    mutable RTS_mutex_t shortNameMutex;
+    ShortNames shortNames;
+};
+
+#endif
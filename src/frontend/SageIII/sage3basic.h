@@ -295,6 +295,9 @@ namespace Exec { namespace ELF { class ElfFileHeader; }; };
 // separate file (out of the code generation via ROSETTA).
 #include "manglingSupport.h"
 
+// Thread-safe cache of mangled names (used by the get_mangled_name() member functions).
+#include "mangledNameCache.h"
+
 // Markus Kowarschik: we use the new mechanism of handling preprocessing info;
 // i.e., we output the preprocessing info attached to the AST nodes.
 // See the detailed explanation of the mechanisms in the beginning of file
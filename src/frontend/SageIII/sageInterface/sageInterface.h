@@ -408,6 +408,16 @@ struct hash_nodeptr
   std::string getMangledNameFromCache (SgNode * astNode);
   std::string addMangledNameToCache (SgNode * astNode, const std::string & mangledName);
 
+  /*! \brief Removes the cached mangled names of an IR node and of all IR nodes in the subtree below it.
+
+      This must be called after transformations that change something a cached mangled name depends
+      upon (names, scopes, parameter lists).  Names cached for IR nodes outside the subtree that embed
+      one of these names (e.g., types referring to a renamed class) are not affected; use
+      SgNode::clearGlobalMangledNameMap() if those may have been computed.  set_name() and
+      moveStatementsBetweenBlocks() call this for the IR nodes they modify.
+   */
+  void invalidateMangledNameCache (SgNode * astNode);
+
   SgDeclarationStatement * getNonInstantiatonDeclarationForClass (SgTemplateInstantiationMemberFunctionDecl * memberFunctionInstantiation);
 
   //! a better version for SgVariableDeclaration::set_baseTypeDefininingDeclaration(), handling all side effects automatically
@@ -1216,6 +1216,11 @@ SgFile::usage ( int status )
 "                             ignore all comments and CPP directives (can\n"
 "                             generate (unparse) invalid code if not used with\n"
 "                             -rose:unparse_includes)\n"
+"     -rose:lazy_commentsAndDirectives\n"
+"                             attach comments and CPP directives only when they\n"
+"                             are first used (by the unparser or by\n"
+"                             getAttachedPreprocessingInfo()); faster for\n"
+"                             analysis-only tools\n"
 "     -rose:prelink           activate prelink mechanism to force instantiation\n"
 "                             of templates and assignment to files\n"
 "     -rose:instantiation XXX control template instantiation\n"
@@ -1223,6 +1228,8 @@ SgFile::usage ( int status )
 "     -rose:read_executable_file_format_only\n"
 "                             ignore disassemble of instructions (helps debug binary \n"
 "                             file format for binaries)\n"
+"     -rose:lazy_dwarf        build the Dwarf IR nodes of each compilation unit only\n"
+"                             when the unit is first used (binaries only)\n"
 "\n"
 "GNU g++ options recognized:\n"
 "     -ansi                   equivalent to -rose:strict\n"
@@ -2324,6 +2331,15 @@ SgFile::processRoseCommandLineOptions ( vector<string> & argv )
        // set_collectAllCommentsAndDirectives(false);
         }
 
+  //
+  // lazy_commentsAndDirectives option: comments and CPP directives are collected and attached to the AST
+  // the first time they are used instead of in the frontend (analysis-only tools may never use them).
+  //
+     if ( CommandlineProcessing::isOption(argv,"-rose:","(lazy_commentsAndDirectives)",true) == true )
+        {
+          set_lazy_commentsAndDirectives(true);
+        }
+
   // DQ (8/16/2008): parse binary executable file format only (some uses of ROSE may only do analysis of
   // the binary executable file format and not the instructions).  This is also useful for testing.
      if ( CommandlineProcessing::isOption(argv,"-rose:","(read_executable_file_format_only)",true) == true )
@@ -2350,6 +2366,15 @@ SgFile::processRoseCommandLineOptions ( vector<string> & argv )
           set_visualize_dwarf_only(true);
         }
 
+  //
+  // lazy_dwarf option: the Dwarf IR nodes of each compilation unit are built the first time the unit's
+  // children are requested instead of when the binary is read (most tools never look at most of them).
+  //
+     if ( CommandlineProcessing::isOption(argv,"-rose:","(lazy_dwarf)",true) == true )
+        {
+          set_lazy_dwarf(true);
+        }
+
   // DQ (1/10/2009): The C language ASM statements are providing significant trouble, they are
   // frequently machine specific and we are compiling then on architectures for which they were
   // not designed.  This option allows then to be read, constructed in the AST to support analysis
@@ -2686,6 +2711,7 @@ SgFile::stripRoseCommandLineOptions ( vector<string> & argv )
      optionCount = sla(argv, "-rose:", "($)", "(collectAllCommentsAndDirectives)",1);
      optionCount = sla(argv, "-rose:", "($)", "(unparseHeaderFiles)",1);
      optionCount = sla(argv, "-rose:", "($)", "(skip_commentsAndDirectives)",1);
+     optionCount = sla(argv, "-rose:", "($)", "(lazy_commentsAndDirectives)",1);
      optionCount = sla(argv, "-rose:", "($)", "(skipfinalCompileStep)",1);
      optionCount = sla(argv, "-rose:", "($)", "(prelink)",1);
      optionCount = sla(argv, "-"     , "($)", "(ansi)",1);
@@ -2740,6 +2766,7 @@ SgFile::stripRoseCommandLineOptions ( vector<string> & argv )
      optionCount = sla(argv, "-rose:", "($)", "(read_executable_file_format_only)",1);
      optionCount = sla(argv, "-rose:", "($)", "(visualize_executable_file_format_skip_symbols)",1);
      optionCount = sla(argv, "-rose:", "($)", "(visualize_dwarf_only)",1);
+     optionCount = sla(argv, "-rose:", "($)", "(lazy_dwarf)",1);
 
   // DQ (10/18/2009): Sometimes we need to skip the parsing of the file format
      optionCount = sla(argv, "-rose:", "($)", "(read_instructions_only)",1);
@@ -2303,7 +2303,16 @@ SgFile::secondaryPassOverSourceFile()
             // printf ("In SgFile::secondaryPassOverSourceFile(): requiresCPP = %s \n",requiresCPP ? "true" : "false");
                if (requiresCPP == false)
                   {
-                    attachPreprocessingInfo(sourceFile);
+                 // Deferred attachment is not used for Fortran (comments can hold directives) or with OpenMP 
+                 // (processOpenMP() below looks at the attached comments and CPP directives).
+                    if (get_lazy_commentsAndDirectives() == true && get_Fortran_only() == false && get_openmp() == false)
+                       {
+                         deferPreprocessingInfo(sourceFile);
+                       }
+                      else
+                       {
+                         attachPreprocessingInfo(sourceFile);
+                       }
                  // printf ("Exiting as a test (should not be called for Fortran CPP source files) \n");
                  // ROSE_ASSERT(false);
                   }
@@ -3,6 +3,7 @@
 
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/depth_first_search.hpp>
+#include <boost/unordered_map.hpp>
 
 class SgNode;
 class SgAsmBlock;
@@ -330,7 +331,7 @@ namespace BinaryAnalysis {
             VertexList *forward_order;
             FlowOrder(VertexList *forward_order): forward_order(forward_order) {}
             void compute(const ControlFlowGraph &g, Vertex v0, ReverseVertexList *reverse_order);
-            void finish_vertex(Vertex v, ControlFlowGraph g);
+            void finish_vertex(Vertex v, const ControlFlowGraph &g);
         };
             
         /* Helper class for build_cfg_from_ast().  Adds vertices to its 'cfg' member. Vertices are any SgAsmBlock that contains
@@ -341,18 +342,20 @@ namespace BinaryAnalysis {
             ControlFlow *analyzer;
             ControlFlowGraph &cfg;
             typedef typename boost::graph_traits<ControlFlowGraph>::vertex_descriptor Vertex;
-            typedef std::map<SgAsmBlock*, Vertex> BlockVertexMap;
+            typedef boost::unordered_map<SgAsmBlock*, Vertex> BlockVertexMap;
             BlockVertexMap &bv_map;
             VertexInserter(ControlFlow *analyzer, ControlFlowGraph &cfg, BlockVertexMap &bv_map)
                 : analyzer(analyzer), cfg(cfg), bv_map(bv_map)
                 {}
             // Add basic block to graph if it hasn't been added already.
             void conditionally_add_vertex(SgAsmBlock *block) {
-                if (block && block->has_instructions() && !analyzer->is_vertex_filtered(block) &&
-                    bv_map.find(block)==bv_map.end()) {
-                    Vertex vertex = add_vertex(cfg);
-                    bv_map[block] = vertex;
-                    put(boost::vertex_name, cfg, vertex, block);
+                if (block && block->has_instructions() && !analyzer->is_vertex_filtered(block)) {
+                    std::pair<typename BlockVertexMap::iterator, bool> inserted =
+                        bv_map.insert(std::make_pair(block, boost::graph_traits<ControlFlowGraph>::null_vertex()));
+                    if (inserted.second) {
+                        inserted.first->second = add_vertex(cfg);
+                        put(boost::vertex_name, cfg, inserted.first->second, block);
+                    }
                 }
             }
             void visit(SgNode *node) {
@@ -414,7 +417,7 @@ namespace BinaryAnalysis {
             typedef std::vector<Vertex> Vector;
             Vector &blocks;
             ReturnBlocks(Vector &blocks): blocks(blocks) {}
-            void finish_vertex(Vertex v, ControlFlowGraph g);
+            void finish_vertex(Vertex v, const ControlFlowGraph &g);
         };
 
     public:
@@ -485,9 +488,8 @@ template<class ControlFlowGraph>
 void
 BinaryAnalysis::ControlFlow::build_cfg_from_ast(SgNode *root, ControlFlowGraph &cfg)
 {
-    typedef typename boost::graph_traits<ControlFlowGraph>::vertex_descriptor Vertex;
-    typedef std::map<SgAsmBlock*, Vertex> BlockVertexMap;
-    BlockVertexMap bv_map;
+    typedef typename VertexInserter<ControlFlowGraph>::BlockVertexMap BlockVertexMap;
+    BlockVertexMap bv_map;                      /* hashed; this is a hot spot for functions with very many blocks */
 
     cfg.clear();
     VertexInserter<ControlFlowGraph>(this, cfg, bv_map).traverse(root, preorder);
@@ -595,7 +597,7 @@ BinaryAnalysis::ControlFlow::FlowOrder<ControlFlowGraph>::compute(const ControlF
 
 template<class ControlFlowGraph>
 void
-BinaryAnalysis::ControlFlow::FlowOrder<ControlFlowGraph>::finish_vertex(Vertex v, ControlFlowGraph g) {
+BinaryAnalysis::ControlFlow::FlowOrder<ControlFlowGraph>::finish_vertex(Vertex v, const ControlFlowGraph &g) {
     forward_order->push_back(v);
 }
 
@@ -612,7 +614,7 @@ BinaryAnalysis::ControlFlow::flow_order(const ControlFlowGraph &cfg,
 
 template<class ControlFlowGraph>
 void
-BinaryAnalysis::ControlFlow::ReturnBlocks<ControlFlowGraph>::finish_vertex(Vertex v, ControlFlowGraph g)
+BinaryAnalysis::ControlFlow::ReturnBlocks<ControlFlowGraph>::finish_vertex(Vertex v, const ControlFlowGraph &g)
 {
     typename boost::graph_traits<ControlFlowGraph>::out_edge_iterator ei, ei_end;
     boost::tie(ei, ei_end) = out_edges(v, g);
@@ -0,0 +1,276 @@
+#ifndef ROSE_BinaryAnalysis_FunctionDriver_H
+#define ROSE_BinaryAnalysis_FunctionDriver_H
+
+#include "BinaryFunctionCall.h"
+#include "threadSupport.h"
+
+#include <algorithm>
+#include <exception>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+class SgAsmFunction;
+
+namespace BinaryAnalysis {
+
+    /** Runs a per-function analysis over all functions.
+     *
+     *  Many binary analyses (control flow, dominance, register definitions, the instruction semantics policies) operate on
+     *  one function at a time and are independent of each other except, perhaps, for summaries of the called functions.
+     *  This class runs such an analysis over every function of a function call graph using a pool of threads and returns
+     *  one result per function.
+     *
+     *  The analysis is a copyable functor class that defines a "Result" type and a function operator that takes the function
+     *  to analyze and the (partially filled in) results.  Each worker thread makes its own copy of the functor, so anything
+     *  the functor holds by value (e.g., an instruction semantics policy) is cloned once per thread and never shared.  The
+     *  Result type must be default constructible and assignable.  Each result is written into its own slot of a presized
+     *  vector by the only thread that analyzes that function, so collecting results needs no locking.
+     *
+     *  @code
+     *  struct FindStackDelta {
+     *      typedef int Result;
+     *      PartialSymbolicSemantics::Policy<> policy;      // cloned for each thread
+     *      Result operator()(SgAsmFunction *func, const FunctionDriver::Results<Result> &results) {
+     *          ...
+     *      }
+     *  };
+     *
+     *  FunctionDriver driver;
+     *  driver.set_nthreads(8);
+     *  FunctionDriver::Results<int> deltas = driver.run(interp, FindStackDelta());
+     *  for (size_t i=0; i<deltas.size(); ++i)
+     *      std::cout <<deltas.function(i)->get_name() <<": " <<deltas[i] <<"\n";
+     *  @endcode
+     *
+     *  When the order is BOTTOM_UP, the strongly connected components of the call graph are analyzed in reverse topological
+     *  order: a function is not analyzed until all the functions it calls (other than those in its own component, i.e.,
+     *  mutually recursive functions) have been analyzed, and the analysis can obtain their results with Results::find().
+     *  The functions of one component are analyzed by a single thread in address order.  When the order is UNORDERED (the
+     *  default) the functions are analyzed in any order, largest first, and the analysis must not look at other results. */
+    class FunctionDriver {
+    public:
+        typedef FunctionCall::Graph CallGraph;
+
+        /** Order in which functions are analyzed. */
+        enum Order {
+            UNORDERED,                          /**< Any order; results of other functions are not available. */
+            BOTTOM_UP                           /**< Called functions before their callers, where the call graph permits. */
+        };
+
+        /** Exception thrown by run() when the analysis throws an exception for some function.  The message names the
+         *  function and, if the analysis threw an std::exception, includes its what() message. */
+        struct Exception {
+            Exception(const std::string &mesg): mesg(mesg) {}
+            friend std::ostream& operator<<(std::ostream &o, const Exception &e) {
+                o <<"function driver exception: " <<e.mesg;
+                return o;
+            }
+            std::string mesg;
+        };
+
+        /** One result per function.  Results are indexed by call graph vertex number. */
+        template<class Result>
+        class Results {
+        public:
+            Results(): in_progress(false), bottom_up(false) {}
+
+            /** Number of functions. */
+            size_t size() const { return results.size(); }
+
+            /** Function corresponding to the specified index. */
+            SgAsmFunction *function(size_t i) const { return functions[i]; }
+
+            /** Result for the specified index.
+             * @{ */
+            const Result& operator[](size_t i) const { return results[i]; }
+            Result& operator[](size_t i) { return results[i]; }
+            /** @} */
+
+            /** Returns the result for a function, or the null pointer if the function is not in the call graph.  While
+             *  FunctionDriver::run() is in progress this returns the null pointer in UNORDERED mode, and in BOTTOM_UP mode it
+             *  returns the null pointer for functions that have not been analyzed yet and may be called only for the
+             *  functions called by the function being analyzed. */
+            const Result *find(SgAsmFunction *func) const {
+                std::map<SgAsmFunction*, size_t>::const_iterator found = index.find(func);
+                if (found==index.end() || (in_progress && (!bottom_up || !done[found->second])))
+                    return NULL;
+                return &results[found->second];
+            }
+
+        private:
+            friend class FunctionDriver;
+            std::vector<SgAsmFunction*> functions;
+            std::map<SgAsmFunction*, size_t> index;
+            std::vector<Result> results;
+            std::vector<char> done;             /* Only consulted while a BOTTOM_UP run is in progress. */
+            bool in_progress;
+            bool bottom_up;
+        };
+
+        FunctionDriver(): nthreads(1), order(UNORDERED) {}
+
+        /** Number of worker threads.  A value of one (the default) runs the analysis in the calling thread.  If ROSE was
+         *  configured without thread support then the analysis always runs in the calling thread.
+         * @{ */
+        void set_nthreads(size_t n) { nthreads = n>0 ? n : 1; }
+        size_t get_nthreads() const { return nthreads; }
+        /** @} */
+
+        /** Order in which functions are analyzed.  See Order.
+         * @{ */
+        void set_order(Order order) { this->order = order; }
+        Order get_order() const { return order; }
+        /** @} */
+
+        /** Run an analysis on each function.  The first form builds a function call graph from the AST rooted at @p root
+         *  (usually an SgAsmInterpretation); the second form uses the supplied call graph, which can be used to restrict
+         *  the analysis to certain functions by building the graph with vertex filters.
+         * @{ */
+        template<class Analysis>
+        Results<typename Analysis::Result> run(SgNode *root, const Analysis &analysis) {
+            return run(FunctionCall().build_cg_from_ast<CallGraph>(root), analysis);
+        }
+
+        template<class Analysis>
+        Results<typename Analysis::Result> run(const CallGraph&, const Analysis&);
+        /** @} */
+
+    protected:
+        /* Units of work: the strongly connected components of the call graph (BOTTOM_UP) or single functions (UNORDERED),
+         * handed to worker threads as they become ready.  Defined in BinaryFunctionDriver.C. */
+        class Schedule {
+        public:
+            Schedule(const CallGraph&, Order);
+            ~Schedule();
+
+            /** Blocks until a unit is ready and returns it.  Returns false when all units are finished or the run was
+             *  aborted. */
+            bool next(size_t &unit/*out*/);
+
+            /** Marks a unit finished, making its callers ready when all their callees are finished. */
+            void finished(size_t unit);
+
+            /** Stops handing out units.  Only the first error is remembered. */
+            void abort(const std::string &mesg);
+
+            /** Call graph vertices in a unit, in address order. */
+            const std::vector<size_t>& members(size_t unit) const { return units[unit]; }
+
+            /** Returns the message passed to abort(), or an empty string. */
+            const std::string& error() const { return abort_mesg; }
+
+        private:
+            Schedule(const Schedule&);
+            Schedule& operator=(const Schedule&);
+
+            std::vector<std::vector<size_t> > units;    /* Call graph vertices in each unit. */
+            std::vector<std::vector<size_t> > callers;  /* Units that must wait for each unit. */
+            std::vector<size_t> npending;               /* Number of unfinished units each unit is waiting for. */
+            std::vector<size_t> cost;                   /* Approximate work per unit; larger units are started first. */
+            std::vector<size_t> ready;                  /* Heap of ready units ordered by cost. */
+            size_t nunfinished;
+            std::string abort_mesg;
+            RTS_mutex_t mutex;
+#ifdef ROSE_THREADS_ENABLED
+            pthread_cond_t cond;                        /* Signaled when a unit becomes ready or the last one finishes. */
+#endif
+        };
+
+        /* State for one worker thread. */
+        template<class Analysis>
+        struct Worker {
+            Analysis analysis;                  /* This thread's private copy of the analysis. */
+            Results<typename Analysis::Result> *results;
+            Schedule *schedule;
+            Worker(const Analysis &analysis, Results<typename Analysis::Result> *results, Schedule *schedule)
+                : analysis(analysis), results(results), schedule(schedule) {}
+            void work();
+        };
+
+        template<class W>
+        static void *worker_main(void *worker) {
+            static_cast<W*>(worker)->work();
+            return NULL;
+        }
+
+        /* Calls start(arg) for each arg, each in its own thread (or all in the calling thread if threads are not enabled),
+         * and waits for them all to return. */
+        static void run_threads(void *(*start)(void*), const std::vector<void*> &args);
+
+        size_t nthreads;
+        Order order;
+    };
+}
+
+
+/******************************************************************************************************************************
+ *                                      Function template definitions
+ ******************************************************************************************************************************/
+
+template<class Analysis>
+void
+BinaryAnalysis::FunctionDriver::Worker<Analysis>::work()
+{
+    size_t unit;
+    while (schedule->next(unit/*out*/)) {
+        const std::vector<size_t> &members = schedule->members(unit);
+        for (size_t i=0; i<members.size(); ++i) {
+            size_t v = members[i];
+            try {
+                results->results[v] = analysis(results->functions[v], *results);
+            } catch (const std::exception &e) {
+                std::ostringstream ss;
+                ss <<"analysis failed for function at 0x" <<std::hex <<results->functions[v]->get_entry_va() <<": " <<e.what();
+                schedule->abort(ss.str());
+                return;
+            } catch (...) {
+                std::ostringstream ss;
+                ss <<"analysis failed for function at 0x" <<std::hex <<results->functions[v]->get_entry_va();
+                schedule->abort(ss.str());
+                return;
+            }
+            results->done[v] = 1;
+        }
+        schedule->finished(unit);
+    }
+}
+
+template<class Analysis>
+BinaryAnalysis::FunctionDriver::Results<typename Analysis::Result>
+BinaryAnalysis::FunctionDriver::run(const CallGraph &cg, const Analysis &analysis)
+{
+    typedef typename Analysis::Result Result;
+    size_t nfuncs = num_vertices(cg);
+    Results<Result> results;
+    results.functions.resize(nfuncs, NULL);
+    results.results.resize(nfuncs);
+    results.done.resize(nfuncs, 0);
+    results.in_progress = true;
+    results.bottom_up = BOTTOM_UP==order;
+    for (size_t v=0; v<nfuncs; ++v) {
+        results.functions[v] = get(boost::vertex_name, cg, v);
+        results.index[results.functions[v]] = v;
+    }
+
+    Schedule schedule(cg, order);
+    size_t nworkers = std::max((size_t)1, std::min(nthreads, nfuncs));
+    std::vector<Worker<Analysis>*> workers;
+    std::vector<void*> args;
+    for (size_t i=0; i<nworkers; ++i) {
+        workers.push_back(new Worker<Analysis>(analysis, &results, &schedule));
+        args.push_back(workers.back());
+    }
+    run_threads(worker_main<Worker<Analysis> >, args);
+    for (size_t i=0; i<workers.size(); ++i)
+        delete workers[i];
+
+    if (!schedule.error().empty())
+        throw Exception(schedule.error());
+    results.in_progress = false;
+    results.done.clear();
+    return results;
+}
+
+#endif
@@ -0,0 +1,866 @@
+#ifndef Rose_ConcreteSemantics_H
+#define Rose_ConcreteSemantics_H
+
+#ifndef __STDC_FORMAT_MACROS
+#define __STDC_FORMAT_MACROS
+#endif
+#include <inttypes.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <stdint.h>
+#include <string>
+
+#include "x86InstructionSemantics.h"
+#include "BaseSemantics.h"
+#include "MemoryMap.h"
+#include "FormatRestorer.h"
+#include "integerOps.h"
+
+namespace BinaryAnalysis {                      // documented elsewhere
+    namespace InstructionSemantics {            // documented elsewhere
+
+
+        /** A fast, concrete semantic domain.
+         *
+         *  This policy emulates x86 instructions on known values only.  It is intended for concrete emulation (simulators,
+         *  test harnesses, constant propagation seeded with concrete values) where every value is a plain integer and the
+         *  overhead of the symbolic and partially symbolic domains (reference-counted expressions, named values, one object
+         *  per flag bit) dominates the run time.  The main classes are:
+         *
+         *  <ul>
+         *    <li>Policy: the policy class used to instantiate X86InstructionSemantic instances.</li>
+         *    <li>State: the state of the virtual machine: registers packed into a plain struct, and paged memory.</li>
+         *    <li>ValueType: the values stored in registers and memory and used for memory addresses.</li>
+         *  </ul>
+         *
+         *  A ValueType is a single 64-bit integer, so it is passed in registers and all the RISC operations inline to a few
+         *  machine instructions.  The registers are stored as native integers rather than as ValueType objects: the eight
+         *  general purpose registers and EIP as 32-bit words, the segment registers as 16-bit words, and all thirty-two
+         *  flags as one EFLAGS word, so the whole register file is 64 bytes.  None of the classes have virtual methods.
+         *
+         *  Since every value is known, "undefined" values (e.g., the flags that an instruction leaves undefined) are zero. */
+        namespace ConcreteSemantics {
+
+            /** A value is always known.  Bits above nBits are always zero. */
+            template<size_t nBits>
+            struct ValueType {
+                uint64_t v;
+
+                /** Construct a zero value.  Unlike other domains, there are no unknown values. */
+                ValueType(): v(0) {}
+
+                /** Copy-construct a value, truncating or zero-extending at msb the source value. */
+                template <size_t Len>
+                ValueType(const ValueType<Len> &other)
+                    : v(other.v & IntegerOps::GenMask<uint64_t, nBits>::value) {}
+
+                /** Construct a ValueType with a known value. */
+                ValueType(uint64_t n)   /*implicit*/
+                    : v(n & IntegerOps::GenMask<uint64_t, nBits>::value) {}
+
+                /** Returns true; all values are known. */
+                bool is_known() const {
+                    return true;
+                }
+
+                /** Returns the value. */
+                uint64_t known_value() const {
+                    return v;
+                }
+
+                /** Print the value. */
+                void print(std::ostream &o, BaseSemantics::SEMANTIC_NO_PRINT_HELPER *unused=NULL) const {
+                    FormatRestorer restorer(o); // restore format flags when we leave this scope
+                    o <<"0x" <<std::hex <<v;
+                }
+
+                friend bool operator==(const ValueType &a, const ValueType &b) {
+                    return a.v==b.v;
+                }
+
+                friend bool operator!=(const ValueType &a, const ValueType &b) {
+                    return a.v!=b.v;
+                }
+
+                friend bool operator<(const ValueType &a, const ValueType &b) {
+                    return a.v<b.v;
+                }
+            };
+
+            template<size_t Len>
+            std::ostream& operator<<(std::ostream &o, const ValueType<Len> &e) {
+                e.print(o, (BaseSemantics::SEMANTIC_NO_PRINT_HELPER*)0);
+                return o;
+            }
+
+            /** Sparse, paged memory.  Pages are allocated on first access.  If a memory map is supplied then a newly allocated
+             *  page is initialized from the map (bytes not in the map are zero); the map itself is never modified.  The most
+             *  recently used page is remembered so that consecutive accesses to the same page (instruction fetches, stack
+             *  pushes and pops, string operations) skip the page table. */
+            class Memory {
+            public:
+                enum { PAGE_BITS=12, PAGE_SIZE=1<<PAGE_BITS, TABLE_BITS=10, TABLE_SIZE=1<<TABLE_BITS,
+                       DIR_SIZE=1<<(32-PAGE_BITS-TABLE_BITS) };
+
+                Memory(): map(NULL) {
+                    init();
+                }
+
+                Memory(const Memory &other): map(NULL) {
+                    init();
+                    *this = other;
+                }
+
+                ~Memory() {
+                    clear();
+                }
+
+                Memory& operator=(const Memory &other) {
+                    if (this!=&other) {
+                        clear();
+                        map = other.map;
+                        for (size_t i=0; i<DIR_SIZE; ++i) {
+                            if (!other.dir[i])
+                                continue;
+                            dir[i] = new uint8_t*[TABLE_SIZE]();
+                            for (size_t j=0; j<TABLE_SIZE; ++j) {
+                                if (other.dir[i][j]) {
+                                    dir[i][j] = new uint8_t[PAGE_SIZE];
+                                    memcpy(dir[i][j], other.dir[i][j], PAGE_SIZE);
+                                }
+                            }
+                        }
+                    }
+                    return *this;
+                }
+
+                /** Sets the memory map used to initialize pages.  Pages that have already been accessed are not affected. */
+                void set_map(const MemoryMap *map) {
+                    this->map = map;
+                }
+
+                /** Discards all pages.  The next access to an address reinitializes its page from the memory map. */
+                void clear() {
+                    for (size_t i=0; i<DIR_SIZE; ++i) {
+                        if (dir[i]) {
+                            for (size_t j=0; j<TABLE_SIZE; ++j)
+                                delete[] dir[i][j];
+                            delete[] dir[i];
+                            dir[i] = NULL;
+                        }
+                    }
+                    last_pageno = (uint32_t)-1;
+                    last_page = NULL;
+                }
+
+                /** Returns the number of pages that have been accessed. */
+                size_t npages() const {
+                    size_t retval = 0;
+                    for (size_t i=0; i<DIR_SIZE; ++i) {
+                        for (size_t j=0; dir[i] && j<TABLE_SIZE; ++j)
+                            retval += dir[i][j] ? 1 : 0;
+                    }
+                    return retval;
+                }
+
+                /** Reads a little-endian value of @p nBytes bytes. */
+                template<size_t nBytes>
+                uint64_t read(uint32_t addr) {
+                    uint64_t retval = 0;
+                    uint32_t offset = addr & (PAGE_SIZE-1);
+                    if (offset + nBytes <= PAGE_SIZE) {
+                        const uint8_t *p = page(addr) + offset;
+                        for (size_t i=0; i<nBytes; ++i)
+                            retval |= (uint64_t)p[i] << (8*i);
+                    } else {
+                        for (size_t i=0; i<nBytes; ++i)
+                            retval |= (uint64_t)page(addr+i)[(addr+i) & (PAGE_SIZE-1)] << (8*i);
+                    }
+                    return retval;
+                }
+
+                /** Writes a little-endian value of @p nBytes bytes. */
+                template<size_t nBytes>
+                void write(uint32_t addr, uint64_t value) {
+                    uint32_t offset = addr & (PAGE_SIZE-1);
+                    if (offset + nBytes <= PAGE_SIZE) {
+                        uint8_t *p = page(addr) + offset;
+                        for (size_t i=0; i<nBytes; ++i)
+                            p[i] = value >> (8*i);
+                    } else {
+                        for (size_t i=0; i<nBytes; ++i)
+                            page(addr+i)[(addr+i) & (PAGE_SIZE-1)] = value >> (8*i);
+                    }
+                }
+
+                /** Prints the addresses of the pages that have been accessed. */
+                void print(std::ostream &o, const std::string &prefix="") const {
+                    FormatRestorer restorer(o);
+                    for (size_t i=0; i<DIR_SIZE; ++i) {
+                        for (size_t j=0; dir[i] && j<TABLE_SIZE; ++j) {
+                            if (dir[i][j]) {
+                                uint32_t va = ((i << TABLE_BITS) | j) << PAGE_BITS;
+                                o <<prefix <<"page 0x" <<std::hex <<std::setw(8) <<std::setfill('0') <<va <<"\n";
+                            }
+                        }
+                    }
+                }
+
+            private:
+                void init() {
+                    for (size_t i=0; i<DIR_SIZE; ++i)
+                        dir[i] = NULL;
+                    last_pageno = (uint32_t)-1;
+                    last_page = NULL;
+                }
+
+                /* Returns the page containing the specified address, allocating and initializing it if necessary. */
+                uint8_t *page(uint32_t addr) {
+                    uint32_t pageno = addr >> PAGE_BITS;
+                    if (pageno==last_pageno)
+                        return last_page;
+                    uint8_t **&table = dir[pageno >> TABLE_BITS];
+                    if (!table)
+                        table = new uint8_t*[TABLE_SIZE]();
+                    uint8_t *&pg = table[pageno & (TABLE_SIZE-1)];
+                    if (!pg) {
+                        pg = new uint8_t[PAGE_SIZE]();
+                        if (map) {
+                            /* MemoryMap::read() stops at the first unmapped byte, so read each mapped part of the page with
+                             * one call, starting at the first map segment that overlaps the page.  A page that is mapped
+                             * entirely (the usual case) takes a single read. */
+                            rose_addr_t base = (rose_addr_t)pageno << PAGE_BITS, end = base + PAGE_SIZE, va = base;
+                            const MemoryMap::Segments &segments = map->segments();
+                            for (MemoryMap::Segments::const_iterator si=segments.lower_bound(base);
+                                 si!=segments.end() && va<end && si->first.first()<end; ++si) {
+                                if (si->first.last() < va)
+                                    continue;
+                                va = std::max(va, si->first.first());
+                                size_t nread = map->read(pg+(va-base), va, end-va);
+                                va = nread ? va+nread : std::min(end-1, si->first.last()) + 1;
+                            }
+                        }
+                    }
+                    last_pageno = pageno;
+                    last_page = pg;
+                    return pg;
+                }
+
+                const MemoryMap *map;
+                uint8_t **dir[DIR_SIZE];                /* Page directory; each entry is a table of TABLE_SIZE page pointers. */
+                uint32_t last_pageno;                   /* Page number of last_page, or all bits set. */
+                uint8_t *last_page;                     /* Most recently accessed page. */
+            };
+
+            /** Registers, packed into 64 bytes. */
+            struct RegisterState {
+                static const size_t n_gprs = 8;         /**< Number of general-purpose registers in this state. */
+                static const size_t n_segregs = 6;      /**< Number of segmentation registers in this state. */
+                static const size_t n_flags = 32;       /**< Number of flag registers in this state. */
+
+                uint32_t ip;                            /**< Instruction pointer. */
+                uint32_t gpr[n_gprs];                   /**< General-purpose registers */
+                uint16_t segreg[n_segregs];             /**< Segmentation registers. */
+                uint32_t flags;                         /**< EFLAGS; bit N is the flag whose register descriptor offset is N. */
+
+                RegisterState() {
+                    clear();
+                }
+
+                /** Sets all registers to zero. */
+                void clear() {
+                    memset(this, 0, sizeof(*this));
+                }
+
+                /** Print the registers. */
+                void print(std::ostream &o, const std::string &prefix="") const {
+                    FormatRestorer restorer(o);
+                    o <<std::hex;
+                    for (size_t i=0; i<n_gprs; ++i)
+                        o <<prefix <<std::setw(7) <<std::left <<std::setfill(' ') <<gprToString((X86GeneralPurposeRegister)i)
+                          <<" = 0x" <<std::right <<std::setw(8) <<std::setfill('0') <<gpr[i] <<"\n";
+                    for (size_t i=0; i<n_segregs; ++i)
+                        o <<prefix <<std::setw(7) <<std::left <<std::setfill(' ') <<segregToString((X86SegmentRegister)i)
+                          <<" = 0x" <<std::right <<std::setw(4) <<std::setfill('0') <<segreg[i] <<"\n";
+                    o <<prefix <<"eflags  = 0x" <<std::setw(8) <<flags <<"\n"
+                      <<prefix <<"ip      = 0x" <<std::setw(8) <<ip <<"\n";
+                }
+            };
+
+            /** Machine state: registers and memory.  The layout does not depend on the ValueType template argument, which is
+             *  accepted only so this class can be used as a Policy's State argument. */
+            template <template <size_t> class ValueType=ConcreteSemantics::ValueType>
+            struct State {
+                RegisterState registers;
+                Memory memory;
+
+                /** Sets all registers to zero and discards all memory pages. */
+                void clear() {
+                    registers.clear();
+                    memory.clear();
+                }
+
+                /** Print the state. */
+                void print(std::ostream &o, const std::string &prefix="") const {
+                    registers.print(o, prefix);
+                    memory.print(o, prefix);
+                }
+
+                friend std::ostream& operator<<(std::ostream &o, const State &state) {
+                    state.print(o);
+                    return o;
+                }
+            };
+
+            /** A policy that is supplied to the semantic analysis constructor. */
+            template<
+                template <template <size_t> class ValueType> class State = ConcreteSemantics::State,
+                template <size_t nBits> class ValueType = ConcreteSemantics::ValueType
+                >
+            class Policy: public BaseSemantics::Policy {
+            protected:
+                SgAsmInstruction *cur_insn;         /**< Set by startInstruction(), cleared by finishInstruction() */
+                mutable State<ValueType> cur_state; /**< Current machine state updated by each processInstruction().  The
+                                                     *   data member is mutable because a memory read, although conceptually
+                                                     *   const, may allocate and initialize a page. */
+                size_t ninsns;                      /**< Total number of instructions processed. This is incremented by
+                                                     *   startInstruction(), which is the first thing called by
+                                                     *   X86InstructionSemantics::processInstruction(). */
+
+            public:
+                typedef State<ValueType> StateType;
+
+                Policy(): cur_insn(NULL), ninsns(0) {
+                    set_register_dictionary(RegisterDictionary::dictionary_pentium4());
+                }
+
+                /** Set the memory map that holds the initial values of memory.  This map is not modified by the policy and
+                 *  data is read from but not written to the map.  Pages of memory that have already been accessed are not
+                 *  affected. */
+                void set_map(const MemoryMap *map) {
+                    cur_state.memory.set_map(map);
+                }
+
+                /** Returns the number of instructions processed. This counter is incremented at the beginning of each
+                 *  instruction. */
+                size_t get_ninsns() const {
+                    return ninsns;
+                }
+
+                /** Sets the number instructions processed. This is the same counter incremented at the beginning of each
+                 *  instruction and returned by get_ninsns(). */
+                void set_ninsns(size_t n) {
+                    ninsns = n;
+                }
+
+                /** Returns current instruction. Returns the null pointer if no instruction is being processed. */
+                SgAsmInstruction *get_insn() const {
+                    return cur_insn;
+                }
+
+                /** Returns the current state.
+                 * @{ */
+                const State<ValueType>& get_state() const { return cur_state; }
+                State<ValueType>& get_state() { return cur_state; }
+                /** @} */
+
+                /** Returns the current instruction pointer. */
+                ValueType<32> get_ip() const { return ValueType<32>(cur_state.registers.ip); }
+
+                /** Print the current state of this policy. */
+                void print(std::ostream &o) const {
+                    cur_state.print(o);
+                }
+
+                friend std::ostream& operator<<(std::ostream &o, const Policy &p) {
+                    p.print(o);
+                    return o;
+                }
+
+
+
+                /*************************************************************************************************************
+                 * Functions invoked by the X86InstructionSemantics class for every processed instruction or block
+                 *************************************************************************************************************/
+
+                /** See NullSemantics::Policy::startInstruction() */
+                void startInstruction(SgAsmInstruction *insn) {
+                    cur_state.registers.ip = insn->get_address();
+                    ++ninsns;
+                    cur_insn = insn;
+                }
+
+                /** See NullSemantics::Policy::finishInstruction() */
+                void finishInstruction(SgAsmInstruction*) {
+                    cur_insn = NULL;
+                }
+
+                /* Called at the beginning of X86InstructionSemantics::processBlock() */
+                void startBlock(rose_addr_t addr) {}
+
+                /* Called at the end of X86InstructionSemantics::processBlock() */
+                void finishBlock(rose_addr_t addr) {}
+
+
+
+                /*************************************************************************************************************
+                 * Functions invoked by the X86InstructionSemantics class to construct values
+                 *************************************************************************************************************/
+
+                /** See NullSemantics::Policy::true_() */
+                ValueType<1> true_() const {
+                    return ValueType<1>(1);
+                }
+
+                /** See NullSemantics::Policy::false_() */
+                ValueType<1> false_() const {
+                    return ValueType<1>(0);
+                }
+
+                /** See NullSemantics::Policy::undefined_().  Undefined values are zero in this domain. */
+                template <size_t Len>
+                ValueType<Len> undefined_() const {
+                    return ValueType<Len>(0);
+                }
+
+                /** See NullSemantics::Policy::number() */
+                template <size_t Len>
+                ValueType<Len> number(uint64_t n) const {
+                    return ValueType<Len>(n);
+                }
+
+
+
+                /*************************************************************************************************************
+                 * Functions invoked by the X86InstructionSemantics class for individual instructions
+                 *************************************************************************************************************/
+
+                /** See NullSemantics::Policy::filterCallTarget() */
+                ValueType<32> filterCallTarget(const ValueType<32> &a) const {
+                    return a;
+                }
+
+                /** See NullSemantics::Policy::filterReturnTarget() */
+                ValueType<32> filterReturnTarget(const ValueType<32> &a) const {
+                    return a;
+                }
+
+                /** See NullSemantics::Policy::filterIndirectJumpTarget() */
+                ValueType<32> filterIndirectJumpTarget(const ValueType<32> &a) const {
+                    return a;
+                }
+
+                /** See NullSemantics::Policy::hlt().  Subclasses that emulate a whole machine should hide this method. */
+                void hlt() {
+                    throw Exception("hlt is not supported by this policy");
+                }
+
+                /** See NullSemantics::Policy::cpuid() */
+                void cpuid() {} // FIXME
+
+                /** See NullSemantics::Policy::rdtsc() */
+                ValueType<64> rdtsc() {
+                    return 0;
+                }
+
+                /** See NullSemantics::Policy::interrupt().  Subclasses that emulate an operating system should hide this
+                 *  method. */
+                void interrupt(uint8_t num) {
+                    throw Exception("interrupts are not supported by this policy");
+                }
+
+                /** See NullSemantics::Policy::sysenter().  Subclasses that emulate an operating system should hide this
+                 *  method. */
+                void sysenter() {
+                    throw Exception("sysenter is not supported by this policy");
+                }
+
+
+
+                /*************************************************************************************************************
+                 * Functions invoked by the X86InstructionSemantics class for data access operations
+                 *************************************************************************************************************/
+
+                /** Reads from a named register. */
+                template<size_t Len/*bits*/>
+                ValueType<Len> readRegister(const char *regname) {
+                    return readRegister<Len>(findRegister(regname, Len));
+                }
+
+                /** Writes to a named register. */
+                template<size_t Len/*bits*/>
+                void writeRegister(const char *regname, const ValueType<Len> &value) {
+                    writeRegister<Len>(findRegister(regname, Len), value);
+                }
+
+                /** Generic register read.  Accepts the same registers as the policies that use ReadWriteRegisterFragment.h,
+                 *  but operates on the packed register state directly. */
+                template<size_t Len>
+                ValueType<Len> readRegister(const RegisterDescriptor &reg) {
+                    const RegisterState &regs = cur_state.registers;
+                    unsigned minor = reg.get_minor(), offset = reg.get_offset();
+                    switch (Len) {
+                        case 1:
+                            // Only FLAGS/EFLAGS bits have a size of one.
+                            if (reg.get_major()!=x86_regclass_flags)
+                                throw Exception("bit access only valid for FLAGS/EFLAGS register");
+                            if (minor!=0 || offset>=regs.n_flags)
+                                throw Exception("register not implemented in semantic policy");
+                            if (reg.get_nbits()!=1)
+                                throw Exception("semantic policy supports only single-bit flags");
+                            return ValueType<Len>((regs.flags >> offset) & 1);
+
+                        case 8:
+                            // Only the low-order byte or the next higher byte of general-purpose registers, e.g., "al", "ah".
+                            if (reg.get_major()!=x86_regclass_gpr)
+                                throw Exception("byte access only valid for general purpose registers");
+                            if (minor>=regs.n_gprs)
+                                throw Exception("register not implemented in semantic policy");
+                            if (offset!=0 && offset!=8)
+                                throw Exception("invalid one-byte access offset");
+                            return ValueType<Len>(regs.gpr[minor] >> offset);
+
+                        case 16:
+                            if (reg.get_nbits()!=16)
+                                throw Exception("invalid 2-byte register");
+                            if (offset!=0)
+                                throw Exception("policy does not support non-zero offsets for word granularity register access");
+                            switch (reg.get_major()) {
+                                case x86_regclass_segment:
+                                    if (minor>=regs.n_segregs)
+                                        throw Exception("register not implemented in semantic policy");
+                                    return ValueType<Len>(regs.segreg[minor]);
+                                case x86_regclass_gpr:
+                                    if (minor>=regs.n_gprs)
+                                        throw Exception("register not implemented in semantic policy");
+                                    return ValueType<Len>(regs.gpr[minor]);
+                                case x86_regclass_flags:
+                                    if (minor!=0)
+                                        throw Exception("register not implemented in semantic policy");
+                                    return ValueType<Len>(regs.flags);
+                                default:
+                                    throw Exception("word access not valid for this register type");
+                            }
+
+                        case 32:
+                            if (offset!=0)
+                                throw Exception("policy does not support non-zero offsets for double word granularity register access");
+                            switch (reg.get_major()) {
+                                case x86_regclass_gpr:
+                                    if (minor>=regs.n_gprs)
+                                        throw Exception("register not implemented in semantic policy");
+                                    return ValueType<Len>(regs.gpr[minor]);
+                                case x86_regclass_ip:
+                                    if (minor!=0)
+                                        throw Exception("register not implemented in semantic policy");
+                                    return ValueType<Len>(regs.ip);
+                                case x86_regclass_segment:
+                                    if (minor>=regs.n_segregs || reg.get_nbits()!=16)
+                                        throw Exception("register not implemented in semantic policy");
+                                    return ValueType<Len>(regs.segreg[minor]);
+                                case x86_regclass_flags:
+                                    if (minor!=0)
+                                        throw Exception("register not implemented in semantic policy");
+                                    if (reg.get_nbits()!=32)
+                                        throw Exception("register is not 32 bits");
+                                    return ValueType<Len>(regs.flags);
+                                default:
+                                    throw Exception("double word access not valid for this register type");
+                            }
+
+                        default:
+                            throw Exception("invalid register access width");
+                    }
+                }
+
+                /** Generic register write.  See readRegister(). */
+                template<size_t Len>
+                void writeRegister(const RegisterDescriptor &reg, const ValueType<Len> &value) {
+                    RegisterState &regs = cur_state.registers;
+                    unsigned minor = reg.get_minor(), offset = reg.get_offset();
+                    switch (Len) {
+                        case 1:
+                            if (reg.get_major()!=x86_regclass_flags)
+                                throw Exception("bit access only valid for FLAGS/EFLAGS register");
+                            if (minor!=0 || offset>=regs.n_flags)
+                                throw Exception("register not implemented in semantic policy");
+                            if (reg.get_nbits()!=1)
+                                throw Exception("semantic policy supports only single-bit flags");
+                            regs.flags = (regs.flags & ~((uint32_t)1 << offset)) | ((uint32_t)(value.v & 1) << offset);
+                            break;
+
+                        case 8:
+                            if (reg.get_major()!=x86_regclass_gpr)
+                                throw Exception("byte access only valid for general purpose registers.");
+                            if (minor>=regs.n_gprs)
+                                throw Exception("register not implemented in semantic policy");
+                            if (offset!=0 && offset!=8)
+                                throw Exception("invalid byte access offset");
+                            regs.gpr[minor] = (regs.gpr[minor] & ~((uint32_t)0xff << offset)) | ((uint32_t)value.v << offset);
+                            break;
+
+                        case 16:
+                            if (reg.get_nbits()!=16)
+                                throw Exception("invalid 2-byte register");
+                            if (offset!=0)
+                                throw Exception("policy does not support non-zero offsets for word granularity register access");
+                            switch (reg.get_major()) {
+                                case x86_regclass_segment:
+                                    if (minor>=regs.n_segregs)
+                                        throw Exception("register not implemented in semantic policy");
+                                    regs.segreg[minor] = value.v;
+                                    break;
+                                case x86_regclass_gpr:
+                                    if (minor>=regs.n_gprs)
+                                        throw Exception("register not implemented in semantic policy");
+                                    regs.gpr[minor] = (regs.gpr[minor] & 0xffff0000) | (uint32_t)value.v;
+                                    break;
+                                case x86_regclass_flags:
+                                    if (minor!=0)
+                                        throw Exception("register not implemented in semantic policy");
+                                    regs.flags = (regs.flags & 0xffff0000) | (uint32_t)value.v;
+                                    break;
+                                default:
+                                    throw Exception("word access not valid for this register type");
+                            }
+                            break;
+
+                        case 32:
+                            if (offset!=0)
+                                throw Exception("policy does not support non-zero offsets for double word granularity register access");
+                            switch (reg.get_major()) {
+                                case x86_regclass_gpr:
+                                    if (minor>=regs.n_gprs)
+                                        throw Exception("register not implemented in semantic policy");
+                                    regs.gpr[minor] = value.v;
+                                    break;
+                                case x86_regclass_ip:
+                                    if (minor!=0)
+                                        throw Exception("register not implemented in semantic policy");
+                                    regs.ip = value.v;
+                                    break;
+                                case x86_regclass_flags:
+                                    if (minor!=0)
+                                        throw Exception("register not implemented in semantic policy");
+                                    if (reg.get_nbits()!=32)
+                                        throw Exception("register is not 32 bits");
+                                    regs.flags = value.v;
+                                    break;
+                                default:
+                                    throw Exception("double word access not valid for this register type");
+                            }
+                            break;
+
+                        default:
+                            throw Exception("invalid register access width");
+                    }
+                }
+
+                /** See NullSemantics::Policy::readMemory().  Memory is flat; the segment register is ignored. */
+                template <size_t Len> ValueType<Len>
+                readMemory(X86SegmentRegister segreg, const ValueType<32> &addr, const ValueType<1> &cond) const {
+                    if (!cond.v)
+                        return ValueType<Len>(0);
+                    return ValueType<Len>(cur_state.memory.template read<Len/8>(addr.v));
+                }
+
+                /** See NullSemantics::Policy::writeMemory().  Memory is flat; the segment register is ignored. */
+                template <size_t Len> void
+                writeMemory(X86SegmentRegister segreg, const ValueType<32> &addr, const ValueType<Len> &data,
+                            const ValueType<1> &cond) {
+                    if (cond.v)
+                        cur_state.memory.template write<Len/8>(addr.v, data.v);
+                }
+
+
+
+                /*************************************************************************************************************
+                 * Functions invoked by the X86InstructionSemantics class for arithmetic operations
+                 *************************************************************************************************************/
+
+                /** See NullSemantics::Policy::add() */
+                template <size_t Len>
+                ValueType<Len> add(const ValueType<Len> &a, const ValueType<Len> &b) const {
+                    return ValueType<Len>(a.v + b.v);
+                }
+
+                /** See NullSemantics::Policy::addWithCarries() */
+                template <size_t Len>
+                ValueType<Len> addWithCarries(const ValueType<Len> &a, const ValueType<Len> &b, const ValueType<1> &c,
+                                              ValueType<Len> &carry_out) const {
+                    uint64_t sum = a.v + b.v + c.v;
+                    carry_out = ValueType<Len>((a.v & b.v) | ((a.v | b.v) & ~sum));
+                    return ValueType<Len>(sum);
+                }
+
+                /** See NullSemantics::Policy::and_() */
+                template <size_t Len>
+                ValueType<Len> and_(const ValueType<Len> &a, const ValueType<Len> &b) const {
+                    return ValueType<Len>(a.v & b.v);
+                }
+
+                /** See NullSemantics::Policy::equalToZero() */
+                template <size_t Len>
+                ValueType<1> equalToZero(const ValueType<Len> &a) const {
+                    return ValueType<1>(0==a.v ? 1 : 0);
+                }
+
+                /** See NullSemantics::Policy::invert() */
+                template <size_t Len>
+                ValueType<Len> invert(const ValueType<Len> &a) const {
+                    return ValueType<Len>(~a.v);
+                }
+
+                /** See NullSemantics::Policy::concat() */
+                template<size_t Len1, size_t Len2>
+                ValueType<Len1+Len2> concat(const ValueType<Len1> &a, const ValueType<Len2> &b) const {
+                    return ValueType<Len1+Len2>(a.v | (b.v << Len1));
+                }
+
+                /** See NullSemantics::Policy::extract() */
+                template <size_t BeginAt, size_t EndAt, size_t Len>
+                ValueType<EndAt-BeginAt> extract(const ValueType<Len> &a) const {
+                    return ValueType<EndAt-BeginAt>(a.v >> BeginAt);
+                }
+
+                /** See NullSemantics::Policy::ite() */
+                template <size_t Len>
+                ValueType<Len> ite(const ValueType<1> &sel, const ValueType<Len> &ifTrue, const ValueType<Len> &ifFalse) const {
+                    return sel.v ? ifTrue : ifFalse;
+                }
+
+                /** See NullSemantics::Policy::leastSignificantSetBit() */
+                template <size_t Len>
+                ValueType<Len> leastSignificantSetBit(const ValueType<Len> &a) const {
+                    for (size_t i=0; i<Len; ++i) {
+                        if (a.v & ((uint64_t)1 << i))
+                            return ValueType<Len>(i);
+                    }
+                    return ValueType<Len>(0);
+                }
+
+                /** See NullSemantics::Policy::mostSignificantSetBit() */
+                template <size_t Len>
+                ValueType<Len> mostSignificantSetBit(const ValueType<Len> &a) const {
+                    for (size_t i=Len; i>0; --i) {
+                        if (a.v & ((uint64_t)1 << (i-1)))
+                            return ValueType<Len>(i-1);
+                    }
+                    return ValueType<Len>(0);
+                }
+
+                /** See NullSemantics::Policy::negate() */
+                template <size_t Len>
+                ValueType<Len> negate(const ValueType<Len> &a) const {
+                    return ValueType<Len>(-a.v);
+                }
+
+                /** See NullSemantics::Policy::or_() */
+                template <size_t Len>
+                ValueType<Len> or_(const ValueType<Len> &a, const ValueType<Len> &b) const {
+                    return ValueType<Len>(a.v | b.v);
+                }
+
+                /** See NullSemantics::Policy::rotateLeft() */
+                template <size_t Len, size_t SALen>
+                ValueType<Len> rotateLeft(const ValueType<Len> &a, const ValueType<SALen> &sa) const {
+                    return ValueType<Len>(IntegerOps::rotateLeft<Len>(a.v, sa.v));
+                }
+
+                /** See NullSemantics::Policy::rotateRight() */
+                template <size_t Len, size_t SALen>
+                ValueType<Len> rotateRight(const ValueType<Len> &a, const ValueType<SALen> &sa) const {
+                    return ValueType<Len>(IntegerOps::rotateRight<Len>(a.v, sa.v));
+                }
+
+                /** See NullSemantics::Policy::shiftLeft() */
+                template <size_t Len, size_t SALen>
+                ValueType<Len> shiftLeft(const ValueType<Len> &a, const ValueType<SALen> &sa) const {
+                    return ValueType<Len>(IntegerOps::shiftLeft<Len>(a.v, sa.v));
+                }
+
+                /** See NullSemantics::Policy::shiftRight() */
+                template <size_t Len, size_t SALen>
+                ValueType<Len> shiftRight(const ValueType<Len> &a, const ValueType<SALen> &sa) const {
+                    return ValueType<Len>(IntegerOps::shiftRightLogical<Len>(a.v, sa.v));
+                }
+
+                /** See NullSemantics::Policy::shiftRightArithmetic() */
+                template <size_t Len, size_t SALen>
+                ValueType<Len> shiftRightArithmetic(const ValueType<Len> &a, const ValueType<SALen> &sa) const {
+                    return ValueType<Len>(IntegerOps::shiftRightArithmetic<Len>(a.v, sa.v));
+                }
+
+                /** See NullSemantics::Policy::signExtend() */
+                template <size_t FromLen, size_t ToLen>
+                ValueType<ToLen> signExtend(const ValueType<FromLen> &a) const {
+                    return ValueType<ToLen>(IntegerOps::signExtend<FromLen, ToLen>(a.v));
+                }
+
+                /** See NullSemantics::Policy::signedDivide() */
+                template <size_t Len1, size_t Len2>
+                ValueType<Len1> signedDivide(const ValueType<Len1> &a, const ValueType<Len2> &b) const {
+                    if (0==b.v) throw Exception("division by zero");
+                    int64_t numerator = IntegerOps::signExtend<Len1, 64>(a.v);
+                    int64_t denominator = IntegerOps::signExtend<Len2, 64>(b.v);
+                    if (-1==denominator) return negate(a); // avoids overflow trap for INT64_MIN/-1
+                    return ValueType<Len1>(numerator / denominator);
+                }
+
+                /** See NullSemantics::Policy::signedModulo() */
+                template <size_t Len1, size_t Len2>
+                ValueType<Len2> signedModulo(const ValueType<Len1> &a, const ValueType<Len2> &b) const {
+                    if (0==b.v) throw Exception("division by zero");
+                    int64_t numerator = IntegerOps::signExtend<Len1, 64>(a.v);
+                    int64_t denominator = IntegerOps::signExtend<Len2, 64>(b.v);
+                    if (-1==denominator) return ValueType<Len2>(0);
+                    return ValueType<Len2>(numerator % denominator);
+                }
+
+                /** See NullSemantics::Policy::signedMultiply() */
+                template <size_t Len1, size_t Len2>
+                ValueType<Len1+Len2> signedMultiply(const ValueType<Len1> &a, const ValueType<Len2> &b) const {
+                    return ValueType<Len1+Len2>(IntegerOps::signExtend<Len1, 64>(a.v) * IntegerOps::signExtend<Len2, 64>(b.v));
+                }
+
+                /** See NullSemantics::Policy::unsignedDivide() */
+                template <size_t Len1, size_t Len2>
+                ValueType<Len1> unsignedDivide(const ValueType<Len1> &a, const ValueType<Len2> &b) const {
+                    if (0==b.v) throw Exception("division by zero");
+                    return ValueType<Len1>(a.v / b.v);
+                }
+
+                /** See NullSemantics::Policy::unsignedExtend() */
+                template <size_t FromLen, size_t ToLen>
+                ValueType<ToLen> unsignedExtend(const ValueType<FromLen> &a) const {
+                    return ValueType<ToLen>(a.v);
+                }
+
+                /** See NullSemantics::Policy::unsignedModulo() */
+                template <size_t Len1, size_t Len2>
+                ValueType<Len2> unsignedModulo(const ValueType<Len1> &a, const ValueType<Len2> &b) const {
+                    if (0==b.v) throw Exception("division by zero");
+                    return ValueType<Len2>(a.v % b.v);
+                }
+
+                /** See NullSemantics::Policy::unsignedMultiply() */
+                template <size_t Len1, size_t Len2>
+                ValueType<Len1+Len2> unsignedMultiply(const ValueType<Len1> &a, const ValueType<Len2> &b) const {
+                    return ValueType<Len1+Len2>(a.v * b.v);
+                }
+
+                /** See NullSemantics::Policy::xor_() */
+                template <size_t Len>
+                ValueType<Len> xor_(const ValueType<Len> &a, const ValueType<Len> &b) const {
+                    return ValueType<Len>(a.v ^ b.v);
+                }
+            };
+
+        } /*namespace*/
+    } /*namespace*/
+} /*namespace*/
+
+#endif
@@ -40,7 +40,9 @@ namespace BinaryAnalysis {                      // documented elsewhere
          *  whether the value is negated. */
         namespace PartialSymbolicSemantics {
 
-            extern uint64_t name_counter;
+            /** Returns a new name for an unknown value.  Names are unique across all threads, so a policy can be copied into
+             *  another thread and continue to create values there. */
+            uint64_t next_name();
 
             typedef std::map<uint64_t, uint64_t> RenameMap;
 
@@ -54,7 +56,7 @@ namespace BinaryAnalysis {                      // documented elsewhere
                                                      *    constants. */
 
                 /** Construct a value that is unknown and unique. */
-                ValueType(): name(++name_counter), offset(0), negate(false) {}
+                ValueType(): name(next_name()), offset(0), negate(false) {}
 
                 /** Copy-construct a value, truncating or extending at msb the source value. */
                 template <size_t Len>
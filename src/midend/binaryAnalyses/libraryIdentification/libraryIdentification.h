@@ -56,11 +56,29 @@ namespace LibraryIdentification
          bool get_function_match(library_handle & handle, const SgUnsignedCharList & opcode_vector) const;
          bool get_function_match(library_handle & handle, const unsigned char* str, size_t str_length );
 
+      // Read all the entries of the database into a table sorted by signature.  After this the 
+      // get_function_match() functions search the table instead of querying the database once per 
+      // function, which is what dominates the time to match all the functions of a large binary.
+         void load_function_index();
+
+      // Group the inserts done by set_function_match() into one transaction (instead of one 
+      // implicit transaction, and so one sync of the database file, per function).
+         void begin_transaction();
+         void commit_transaction();
+
        private:
+      // The key stored in the database for a function's (normalized) opcodes.
+         static std::string compute_signature( const unsigned char* str, size_t str_length );
+
          std::string database_name;
 
       // SQLite database handle
          sqlite3x::sqlite3_connection con;
+
+      // Entries of the database sorted by signature (empty unless load_function_index() was called).
+         typedef std::vector<std::pair<std::string,library_handle> > FunctionIndex;
+         FunctionIndex function_index;
+         bool function_index_loaded;
      };
 
   // Add an entry to store the pair <library_handle,string> in the database
@@ -15,6 +15,8 @@
 #include <queue>
 #include <boost/foreach.hpp>
 #include <boost/unordered_map.hpp>
+#include <boost/tuple/tuple.hpp>
+#include <boost/tuple/tuple_comparison.hpp>
 
 class FunctionData;
 
@@ -26,6 +28,38 @@ typedef Rose_STL_Container<SgClassDefinition *> SgClassDefinitionPtrList;
 // This header has to be here since it uses type SgFunctionDeclarationPtrList 
 #include "ClassHierarchyGraph.h"
 
+//! Lookup tables for the call targets of calls through function pointers and of
+//! member function calls. Without them, every call through a function pointer scans
+//! the memory pool for functions of the same type, and every polymorphic call scans
+//! the members of all subclasses. The tables are filled on first use, and stay valid
+//! as long as no functions or classes are added to the AST.
+class CallTargetIndex
+{
+  public:
+    CallTargetIndex(ClassHierarchyWrapper* classHierarchy);
+
+    //! same as CallTargetSet::solveFunctionPointerCall
+    const std::vector<SgFunctionDeclaration*>& solveFunctionPointerCall(SgPointerDerefExp* pointerDerefExp);
+
+    //! same as CallTargetSet::solveMemberFunctionCall (with this index' class hierarchy)
+    const std::vector<SgFunctionDeclaration*>& solveMemberFunctionCall(SgClassType* crtClass,
+            SgMemberFunctionDeclaration* memberFunctionDeclaration, bool polymorphic, bool includePureVirtualFunc);
+
+  private:
+    //! function declarations by the mangled name of their type
+    typedef boost::unordered_map<std::string, std::vector<SgFunctionDeclaration*> > FunctionTypeMap;
+
+    typedef boost::tuple<SgClassType*, SgMemberFunctionDeclaration*, bool, bool> MemberCallKey;
+    typedef std::map<MemberCallKey, std::vector<SgFunctionDeclaration*> > MemberCallMap;
+
+    void buildFunctionTypeMap();
+
+    ClassHierarchyWrapper* classHierarchy;
+    bool functionTypesIndexed;
+    FunctionTypeMap functionsByType;
+    MemberCallMap memberCallTargets;
+};
+
 
 //AS(090707) Added the CallTargetSet namespace to replace the CallGraphFunctionSolver class
 namespace CallTargetSet
@@ -51,10 +85,12 @@ namespace CallTargetSet
   std::vector<SgFunctionDeclaration*> solveConstructorInitializer ( SgConstructorInitializer* sgCtorInit);
 
   // Populates functionList with Properties of all functions that may get called.
+  // Calls through function pointers and member function calls are resolved with index, if given.
   void getPropertiesForExpression(SgExpression* exp,
                                     ClassHierarchyWrapper* classHierarchy,
                                     Rose_STL_Container<SgFunctionDeclaration*>& propList,
-                                    bool includePureVirtualFunc = false);
+                                    bool includePureVirtualFunc = false,
+                                    CallTargetIndex* index = NULL);
 
   //! Populates functionList with definitions of all functions that may get called. This
   //! is basically a wrapper around getPropertiesForExpression that extracts the
@@ -93,7 +129,7 @@ class FunctionData
 
     bool isDefined (); 
 
-    FunctionData(SgFunctionDeclaration* functionDeclaration, SgProject *project, ClassHierarchyWrapper * );
+    FunctionData(SgFunctionDeclaration* functionDeclaration, SgProject *project, ClassHierarchyWrapper *, CallTargetIndex * = NULL );
 
     //! All the callees of this function
     Rose_STL_Container<SgFunctionDeclaration *> functionList;
@@ -163,6 +199,7 @@ CallGraphBuilder::buildCallGraph(Predicate pred)
     Rose_STL_Container<SgNode *> allFunctions = NodeQuery::queryMemoryPool(defFunc, &vv);
 
     ClassHierarchyWrapper classHierarchy(project);
+    CallTargetIndex callTargets(&classHierarchy);
     Rose_STL_Container<SgNode *>::iterator i = allFunctions.begin();
 
     graphNodes.clear();
@@ -194,7 +231,7 @@ CallGraphBuilder::buildCallGraph(Predicate pred)
         //AS(032806) Filter out functions based on criteria in predicate
         if (pred(functionDeclaration) == true)
         {
-            FunctionData functionData(functionDeclaration, project, &classHierarchy);
+            FunctionData functionData(functionDeclaration, project, &classHierarchy, &callTargets);
             ROSE_ASSERT(functionData.functionDeclaration != NULL);
 
             callGraphData.push_back(functionData);
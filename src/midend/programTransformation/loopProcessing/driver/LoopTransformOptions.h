@@ -69,6 +69,8 @@ class LoopTransformOptions
   OptType GetOptimizationType();
  
   void SetOptions  (const std::vector<std::string>& argvList, std::vector<std::string>* known_opt=0);
+  /* restore the default transformations, before any option was applied */
+  void Reset();
 
   void SetBlockSel( LoopBlocking* sel); 
   void SetParSel( LoopPar* sel); 
@@ -0,0 +1,103 @@
+
+#ifndef LOOP_TUNING_H
+#define LOOP_TUNING_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <iostream>
+#include "AstInterface.h"
+
+/*************
+ A tuning configuration is a list of loop transformation options, in the
+ same syntax as the command line (e.g. "-bk1 32 -ic1 -unroll 4"), which is
+ applied on top of the options given to the translator.
+**************/
+typedef std::vector<std::string> LoopTuningConfig;
+
+std::string LoopTuningConfigToString(const LoopTuningConfig& config);
+LoopTuningConfig LoopTuningConfigFromString(const std::string& str);
+
+/*************
+ Persistent record of the best configuration measured for each loop nest.
+ The file has one line per loop nest:
+     <fingerprint> <seconds> <options...>
+ where "-" stands for an empty list of options.
+**************/
+class LoopTuningDatabase
+{
+ public:
+  struct Entry {
+     LoopTuningConfig config;
+     double seconds;
+     Entry() : seconds(0) {}
+  };
+ private:
+  std::map<std::string, Entry> entries;
+ public:
+  bool Load(const std::string& filename);
+  bool Save(const std::string& filename) const;
+  bool Lookup(const std::string& fingerprint, LoopTuningConfig& config) const;
+  void Record(const std::string& fingerprint, const LoopTuningConfig& config,
+              double seconds);
+  unsigned size() const { return entries.size(); }
+};
+
+/*************
+ Empirical search over blocking, interchange, fusion and unrolling
+ parameters for each loop nest.  With -tune_search, every outlineable
+ loop nest is replaced by one copy per configuration, each transformed
+ with that configuration and outlined into its own function, and a
+ dispatch that selects the copy named by $ROSE_LOOP_TUNING_VARIANT and
+ times it (see LoopTuningRuntime.h).  RunSearch() then builds and runs
+ the generated program once per configuration and records the fastest
+ configuration of each nest in the database.  Without -tune_search, loop
+ nests found in the database are transformed with their recorded
+ configuration.
+***************/
+class LoopTuning
+{
+  static std::string dbfile, buildcmd, runcmd;
+  static bool search;
+  static unsigned repeat;
+  static LoopTuningDatabase db;
+  static std::vector<LoopTuningConfig> space;
+  static std::vector<std::string> baseOptions;
+  static unsigned baseUnrollSize;
+  static std::vector<std::string> nests;
+  static std::vector<AstNodePtr> outlineTargets;
+  static std::vector<AstNodePtr> runtimeTargets;
+
+  static void ApplyConfig(const LoopTuningConfig& config);
+  static AstNodePtr TransformVariant(AstInterface& fa, const AstNodePtr& head,
+                                     const LoopTuningConfig& config);
+ public:
+  static void cmdline_configure(const std::vector<std::string>& argv,
+                                std::vector<std::string>* unknown_args=0);
+  static std::string cmdline_help();
+
+  /* the options (besides the tuning ones) given to the translator; each
+     configuration is applied on top of these */
+  static void set_base_options(const std::vector<std::string>& argv);
+
+  static bool IsActive() { return !dbfile.empty(); }
+  static bool DoSearch() { return search; }
+  static const std::vector<LoopTuningConfig>& GetSearchSpace() { return space; }
+
+  static std::string Fingerprint(AstInterface& fa, const AstNodePtr& nest);
+  static bool IsOutlineable(AstInterface& fa, const AstNodePtr& nest);
+
+  /* Transforms the loop nest head as the tuning mode requires; returns false
+     if head is left alone. */
+  static bool TransformLoopNest(AstInterface& fa, const AstNodePtr& head,
+                                AstNodePtr& result);
+  /* Outlines the variants generated by TransformLoopNest; must be called
+     after the enclosing traversal has inserted them into the AST. */
+  static void OutlineVariants(AstInterface& fa);
+
+  /* Builds and runs the generated program once per configuration and saves
+     the fastest configuration of each loop nest in the database. */
+  static bool RunSearch();
+};
+
+#endif
@@ -0,0 +1,72 @@
+/*
+ * Runtime support for the loop nest variants generated with -tune_search
+ * (see LoopTuning.h).  The translated source includes this header.
+ *
+ * rose_loop_tuning_variant() returns the configuration selected by the
+ * environment variable ROSE_LOOP_TUNING_VARIANT (default 0).  The time
+ * spent between rose_loop_tuning_begin(n) and rose_loop_tuning_end(n) is
+ * accumulated for each loop nest n and appended at exit to the file named
+ * by ROSE_LOOP_TUNING_OUTPUT, one "<nest> <seconds>" line per executed
+ * nest.  Each translation unit keeps its own table.
+ */
+#ifndef LOOP_TUNING_RUNTIME_H
+#define LOOP_TUNING_RUNTIME_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#define ROSE_LOOP_TUNING_MAX_NESTS 1024
+
+static int rose_loop_tuning_selected = -1;
+static double rose_loop_tuning_start[ROSE_LOOP_TUNING_MAX_NESTS];
+static double rose_loop_tuning_total[ROSE_LOOP_TUNING_MAX_NESTS];
+static int rose_loop_tuning_executed[ROSE_LOOP_TUNING_MAX_NESTS];
+
+static double rose_loop_tuning_time(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + 1e-6 * tv.tv_usec;
+}
+
+static void rose_loop_tuning_report(void)
+{
+  const char* name = getenv("ROSE_LOOP_TUNING_OUTPUT");
+  FILE* out;
+  int i;
+  if (name == NULL || (out = fopen(name, "a")) == NULL)
+    return;
+  for (i = 0; i < ROSE_LOOP_TUNING_MAX_NESTS; ++i) {
+    if (rose_loop_tuning_executed[i])
+      fprintf(out, "%d %.9f\n", i, rose_loop_tuning_total[i]);
+  }
+  fclose(out);
+}
+
+static int rose_loop_tuning_variant(void)
+{
+  if (rose_loop_tuning_selected < 0) {
+    const char* s = getenv("ROSE_LOOP_TUNING_VARIANT");
+    rose_loop_tuning_selected = s != NULL ? atoi(s) : 0;
+    atexit(rose_loop_tuning_report);
+  }
+  return rose_loop_tuning_selected;
+}
+
+static void rose_loop_tuning_begin(int nest)
+{
+  rose_loop_tuning_variant();
+  if (nest >= 0 && nest < ROSE_LOOP_TUNING_MAX_NESTS)
+    rose_loop_tuning_start[nest] = rose_loop_tuning_time();
+}
+
+static void rose_loop_tuning_end(int nest)
+{
+  if (nest >= 0 && nest < ROSE_LOOP_TUNING_MAX_NESTS) {
+    rose_loop_tuning_total[nest] += rose_loop_tuning_time() - rose_loop_tuning_start[nest];
+    rose_loop_tuning_executed[nest] = 1;
+  }
+}
+
+#endif
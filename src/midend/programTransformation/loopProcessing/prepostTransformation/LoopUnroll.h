@@ -22,6 +22,7 @@ class LoopUnrolling : public PrePostTransformation
      return TransformAstTraverse(fa, root, *this, AstInterface::PostVisit );
   }
   static unsigned get_unrollsize() { return unrollsize; }
+  static void set_unrollsize(unsigned size) { unrollsize = size; }
   static void cmdline_configure(const std::vector<std::string>& argv,
                                 std::vector<std::string>* unknown_args=0); 
   static std::string cmdline_help() ;
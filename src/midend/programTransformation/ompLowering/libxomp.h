@@ -49,6 +49,8 @@ extern void XOMP_sections_end(void);
 /* Called after the current thread is told that all sections are executed. It does not synchronizes all threads. */
 extern void XOMP_sections_end_nowait(void);
 
+// By default tasks are forwarded to the OpenMP runtime library. Linking libxomp_task.a before libxomp.a 
+// replaces both functions with XOMP's work-stealing scheduler (xomp_task.c)
 extern void XOMP_task (void (*) (void *), void *, void (*) (void *, void *),
                        long, long, bool, unsigned);
 extern void XOMP_taskwait (void);
@@ -112,6 +114,11 @@ extern bool XOMP_master(void);
 extern void XOMP_atomic_start (void);
 extern void XOMP_atomic_end (void);
 
+// compare-and-swap of floating point scalars, used by the lock-free updates of omp atomic and reductions
+// (integer and pointer scalars use GCC's __sync builtins instead)
+extern bool XOMP_atomic_cas_float (float* target, float oldval, float newval);
+extern bool XOMP_atomic_cas_double (double* target, double oldval, double newval);
+
 extern void XOMP_loop_end (void);
 extern void XOMP_loop_end_nowait (void);
    // --- end loop functions ---
@@ -1791,14 +1791,257 @@ static SgStatement* findLastDeclarationStatement(SgScopeStatement * scope)
 //    removeStatement(target);
   }
 
+  //! Return true if updates of shared scalars of this type are done without the atomic lock.
+  // The choice depends only on the type, so that all omp atomic statements and reduction copy-backs 
+  // which update the same variable use the same mechanism: updates done with a lock are not atomic with
+  // respect to updates done with compare-and-swap, and the other way round.
+  // Integer and pointer types use GCC's __sync builtins, float and double use XOMP_atomic_cas_float/double().
+  static bool isLockFreeUpdateType(SgType* type)
+  {
+    if (SageInterface::is_Fortran_language())
+      return false;
+    ROSE_ASSERT(type != NULL);
+    type = type->stripTypedefsAndModifiers();
+    if (isStrictIntegerType(type) || isSgPointerType(type))
+      return true;
+#ifdef ENABLE_XOMP
+    if (isSgTypeFloat(type) || isSgTypeDouble(type))
+      return true;
+#endif
+    return false;
+  }
+
+  //! Return true if op is an operator of an omp atomic statement or a reduction, which buildUpdateOp() accepts
+  static bool isUpdateOp(VariantT op)
+  {
+    switch (op)
+    {
+      case V_SgAddOp: case V_SgSubtractOp: case V_SgMultiplyOp: case V_SgDivideOp: case V_SgModOp:
+      case V_SgBitAndOp: case V_SgBitOrOp: case V_SgBitXorOp: case V_SgLshiftOp: case V_SgRshiftOp:
+      case V_SgAndOp: case V_SgOrOp:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  //! Build "lhs op rhs" for an operator of an omp atomic statement or a reduction, return NULL for other operators
+  static SgExpression* buildUpdateOp(VariantT op, SgExpression* lhs, SgExpression* rhs)
+  {
+    switch (op)
+    {
+      case V_SgAddOp:      return buildAddOp(lhs, rhs);
+      case V_SgSubtractOp: return buildSubtractOp(lhs, rhs);
+      case V_SgMultiplyOp: return buildMultiplyOp(lhs, rhs);
+      case V_SgDivideOp:   return buildDivideOp(lhs, rhs);
+      case V_SgModOp:      return buildModOp(lhs, rhs);
+      case V_SgBitAndOp:   return buildBitAndOp(lhs, rhs);
+      case V_SgBitOrOp:    return buildBitOrOp(lhs, rhs);
+      case V_SgBitXorOp:   return buildBitXorOp(lhs, rhs);
+      case V_SgLshiftOp:   return buildLshiftOp(lhs, rhs);
+      case V_SgRshiftOp:   return buildRshiftOp(lhs, rhs);
+      case V_SgAndOp:      return buildAndOp(lhs, rhs);
+      case V_SgOrOp:       return buildOrOp(lhs, rhs);
+      default:             return NULL;
+    }
+  }
+
+  //! Build a statement which atomically performs "shared = shared op value", or "shared = value op shared" if reversed is true,
+  // without taking a lock. The type of shared must be one accepted by isLockFreeUpdateType(). shared and value are used as is (not copied).
+  // op V_SgAssignOp stores value: "shared = value".
+  // If value has the same type as shared, + - & | ^ of integers become a single builtin call
+  //    __sync_fetch_and_add(&shared, value);
+  // The builtins convert value to the type of shared first, so any other update is a compare-and-swap loop, 
+  // which computes the new value as written in the source
+  //    {
+  //      int *__atomic_addr = &shared;
+  //      double __atomic_value = value;
+  //      int __atomic_old;
+  //      do {
+  //        __atomic_old = *__atomic_addr;
+  //      } while (!__sync_bool_compare_and_swap(__atomic_addr, __atomic_old, (int)(__atomic_old op __atomic_value)));
+  //    }
+  static SgStatement* buildLockFreeUpdateStmt(VariantT op, SgExpression* shared, SgExpression* value, bool reversed, SgScopeStatement* scope)
+  {
+    ROSE_ASSERT(shared != NULL && value != NULL && scope != NULL);
+    SgType* shared_type = shared->get_type()->stripTypedefsAndModifiers();
+    ROSE_ASSERT(isLockFreeUpdateType(shared_type));
+    SgType* value_type = value->get_type()->stripTypedefsAndModifiers();
+    if (isSgReferenceType(value_type))
+      value_type = isSgReferenceType(value_type)->get_base_type();
+
+    if (isStrictIntegerType(shared_type) && value_type->stripTypedefsAndModifiers() == shared_type)
+    {
+      string func;
+      switch (op)
+      {
+        case V_SgAddOp:      func = "__sync_fetch_and_add"; break;
+        case V_SgSubtractOp: func = reversed ? "" : "__sync_fetch_and_sub"; break;
+        case V_SgBitAndOp:   func = "__sync_fetch_and_and"; break;
+        case V_SgBitOrOp:    func = "__sync_fetch_and_or"; break;
+        case V_SgBitXorOp:   func = "__sync_fetch_and_xor"; break;
+        default:             break;
+      }
+      if (!func.empty())
+        return buildFunctionCallStmt(func, shared_type, buildExprListExp(buildAddressOfOp(shared), value), scope);
+    }
+
+    SgBasicBlock* bb = buildBasicBlock();
+    bb->set_parent(scope);
+    SgVariableDeclaration* addr_decl = buildVariableDeclaration("__atomic_addr", buildPointerType(shared_type), 
+                                                                buildAssignInitializer(buildAddressOfOp(shared)), bb);
+    appendStatement(addr_decl, bb);
+    SgVariableDeclaration* value_decl = buildVariableDeclaration("__atomic_value", value_type, buildAssignInitializer(value), bb);
+    appendStatement(value_decl, bb);
+    SgVariableDeclaration* old_decl = buildVariableDeclaration("__atomic_old", shared_type, NULL, bb);
+    appendStatement(old_decl, bb);
+
+    SgExpression* new_value = NULL;
+    if (op == V_SgAssignOp)
+      new_value = buildVarRefExp(value_decl);
+    else if (reversed)
+      new_value = buildUpdateOp(op, buildVarRefExp(value_decl), buildVarRefExp(old_decl));
+    else
+      new_value = buildUpdateOp(op, buildVarRefExp(old_decl), buildVarRefExp(value_decl));
+    ROSE_ASSERT(new_value != NULL);
+    string cas_func = "__sync_bool_compare_and_swap";
+    if (isSgTypeFloat(shared_type))
+      cas_func = "XOMP_atomic_cas_float";
+    else if (isSgTypeDouble(shared_type))
+      cas_func = "XOMP_atomic_cas_double";
+    SgExprListExp* parameters = buildExprListExp(buildVarRefExp(addr_decl), buildVarRefExp(old_decl), buildCastExp(new_value, shared_type));
+    SgExpression* cas_call = buildFunctionCallExp(cas_func, buildBoolType(), parameters, bb);
+    SgStatement* load_stmt = buildAssignStatement(buildVarRefExp(old_decl), buildPointerDerefExp(buildVarRefExp(addr_decl)));
+    appendStatement(buildDoWhileStmt(buildBasicBlock(load_stmt), buildNotOp(cas_call)), bb);
+    return bb;
+  }
+
+  //! Return the variable x updated by the body of an omp atomic, or NULL if the body is not an update of a single variable
+  static SgExpression* getAtomicUpdatedExpression(SgStatement* body)
+  {
+    SgExprStatement* expr_stmt = isSgExprStatement(body);
+    if (expr_stmt == NULL)
+      return NULL;
+    SgExpression* exp = expr_stmt->get_expression();
+    if (isSgPlusPlusOp(exp) || isSgMinusMinusOp(exp))
+      return isSgUnaryOp(exp)->get_operand();
+    if (isSgAssignOp(exp) || isSgCompoundAssignOp(exp))
+      return isSgBinaryOp(exp)->get_lhs_operand();
+    return NULL;
+  }
+
+  //! Return true if the lvalues a and b denote the same object: they have the same shape, 
+  // refer to the same symbols and constants, and have no side effects (a[i] and a[i], s.f and s.f, *p and *p).
+  static bool isSameLvalue(SgExpression* a, SgExpression* b)
+  {
+    ROSE_ASSERT(a != NULL && b != NULL);
+    if (a->variantT() != b->variantT())
+      return false;
+    if (isSgFunctionCallExp(a) || isSgAssignOp(a) || isSgCompoundAssignOp(a) || isSgPlusPlusOp(a) || isSgMinusMinusOp(a))
+      return false;
+    if (isSgVarRefExp(a))
+      return isSgVarRefExp(a)->get_symbol() == isSgVarRefExp(b)->get_symbol();
+    if (isSgValueExp(a))
+      return a->unparseToString() == b->unparseToString();
+    if (isSgCastExp(a) && isSgCastExp(a)->get_type() != isSgCastExp(b)->get_type())
+      return false;
+    vector<SgNode*> a_children = a->get_traversalSuccessorContainer();
+    vector<SgNode*> b_children = b->get_traversalSuccessorContainer();
+    if (a_children.size() != b_children.size())
+      return false;
+    for (size_t i = 0; i < a_children.size(); i++)
+    {
+      SgExpression* a_child = isSgExpression(a_children[i]);
+      SgExpression* b_child = isSgExpression(b_children[i]);
+      if (a_child == NULL || b_child == NULL)
+      {
+        if (a_children[i] != b_children[i])
+          return false;
+      }
+      else if (!isSameLvalue(a_child, b_child))
+        return false;
+    }
+    return true;
+  }
+
+  //! Translate the body of an omp atomic into a lock-free update, return NULL if it is not an update of a variable of a lock-free type
+  // Handled forms are x binop= expr, x++, ++x, x--, --x, x = x binop expr and x = expr binop x, 
+  // where binop is + - * / % & | ^ << >> && ||, and x is any lvalue (compared with isSameLvalue()). 
+  // Any other x = expr computes expr and stores it with a compare-and-swap loop on &x.
+  static SgStatement* buildLockFreeAtomicStmt(SgStatement* body, SgScopeStatement* scope)
+  {
+    SgExpression* shared = getAtomicUpdatedExpression(body);
+    if (shared == NULL || !isLockFreeUpdateType(shared->get_type()))
+      return NULL;
+    SgExpression* exp = isSgExprStatement(body)->get_expression();
+    SgExpression* value = NULL;
+    VariantT op = V_SgNode;
+    bool reversed = false;
+    switch (exp->variantT())
+    {
+      case V_SgPlusPlusOp:    op = V_SgAddOp; break;
+      case V_SgMinusMinusOp:  op = V_SgSubtractOp; break;
+      case V_SgPlusAssignOp:  op = V_SgAddOp; break;
+      case V_SgMinusAssignOp: op = V_SgSubtractOp; break;
+      case V_SgMultAssignOp:  op = V_SgMultiplyOp; break;
+      case V_SgDivAssignOp:   op = V_SgDivideOp; break;
+      case V_SgModAssignOp:   op = V_SgModOp; break;
+      case V_SgAndAssignOp:   op = V_SgBitAndOp; break;
+      case V_SgIorAssignOp:   op = V_SgBitOrOp; break;
+      case V_SgXorAssignOp:   op = V_SgBitXorOp; break;
+      case V_SgLshiftAssignOp: op = V_SgLshiftOp; break;
+      case V_SgRshiftAssignOp: op = V_SgRshiftOp; break;
+      case V_SgAssignOp:
+        {
+          // x = x binop expr or x = expr binop x, otherwise a plain store of the right hand side
+          SgExpression* rhs = isSgAssignOp(exp)->get_rhs_operand();
+          SgBinaryOp* rhs_op = isSgBinaryOp(rhs);
+          if (rhs_op != NULL && isUpdateOp(rhs_op->variantT()))
+          {
+            if (isSameLvalue(shared, rhs_op->get_lhs_operand()))
+              op = rhs_op->variantT();
+            else if (isSameLvalue(shared, rhs_op->get_rhs_operand()))
+            {
+              op = rhs_op->variantT();
+              reversed = true;
+            }
+          }
+          if (op == V_SgNode)
+          {
+            op = V_SgAssignOp;
+            value = rhs;
+          }
+          else
+            value = reversed ? rhs_op->get_lhs_operand() : rhs_op->get_rhs_operand();
+          break;
+        }
+      default:
+        break;
+    }
+    if (op == V_SgNode)
+      return NULL;
+
+    SgExpression* value_copy = NULL;
+    if (value == NULL && isSgBinaryOp(exp) != NULL)
+      value = isSgBinaryOp(exp)->get_rhs_operand();
+    if (value != NULL)
+      value_copy = deepCopy(value);
+    else if (isStrictIntegerType(shared->get_type()->stripTypedefsAndModifiers()))
+      value_copy = buildCastExp(buildIntVal(1), shared->get_type()->stripTypedefsAndModifiers()); // x++ and x--
+    else
+      value_copy = buildIntVal(1);
+    return buildLockFreeUpdateStmt(op, deepCopy(shared), value_copy, reversed, scope);
+  }
+
   // Two ways 
-  //1. builtin function TODO
-  //    __sync_fetch_and_add_4(&shared, (unsigned int)local);
+  //1. builtin function 
+  //    __sync_fetch_and_add(&shared, local);
   //2. using atomic runtime call: 
   //    GOMP_atomic_start (); // void GOMP_atomic_start (void); 
   //    shared = shared op local;
   //    GOMP_atomic_end (); // void GOMP_atomic_end (void); 
-  // We use the 2nd method only for now, for simplicity and portability
+  // We use the 1st method for all variables whose type is accepted by isLockFreeUpdateType() (see buildLockFreeAtomicStmt()), 
+  // and the 2nd method for all other variables. A variable is never updated by both.
   void transOmpAtomic(SgNode* node)
   {
     ROSE_ASSERT(node != NULL );
@@ -1808,6 +2051,15 @@ static SgStatement* findLastDeclarationStatement(SgScopeStatement * scope)
     ROSE_ASSERT(scope != NULL );
     SgStatement * body = target->get_body();
     ROSE_ASSERT(body != NULL);
+
+    // Every update of a variable of a lock-free type is lowered here: 
+    // using the lock would not be atomic with respect to the other updates of the variable
+    SgStatement* lock_free_stmt = buildLockFreeAtomicStmt(body, scope);
+    if (lock_free_stmt != NULL)
+    {
+      replaceStatement(target, lock_free_stmt, true);
+      return;
+    }
     
     replaceStatement(target, body, true);
 #ifdef ENABLE_XOMP
@@ -2502,15 +2754,44 @@ static void insertOmpLastprivateCopyBackStmts(SgStatement* ompStmt, vector <SgSt
   // orig_var: the reduction variable's original copy
   // local_decl: the local copy of the reduction variable
   // Two ways to do the reduction operation: 
-  //1. builtin function TODO
-  //    __sync_fetch_and_add_4(&shared, (unsigned int)local);
+  //1. builtin function or compare-and-swap loop, see buildLockFreeUpdateStmt()
+  //    __sync_fetch_and_add(&shared, local);
   //2. using atomic runtime call: 
   //    GOMP_atomic_start ();
   //    shared = shared op local;
   //    GOMP_atomic_end ();
-  // We use the 2nd method only for now for simplicity and portability
+  // Each thread accumulates into its own local copy, so the copy-back happens once per thread. 
+  // As for omp atomic, we use the 1st method when isLockFreeUpdateType() accepts the type of the variable, and the 2nd method otherwise.
+  // Note that the partial results of a '-' reduction are combined by addition (OpenMP 3.0 spec, 2.9.3.6)
 static void insertOmpReductionCopyBackStmts (SgOmpClause::omp_reduction_operator_enum r_operator, vector <SgStatement* >& end_stmt_list,  SgBasicBlock* bb1, SgInitializedName* orig_var, SgVariableDeclaration* local_decl)
 {
+  VariantT op = V_SgNode;
+  switch (r_operator)
+  {
+    case SgOmpClause::e_omp_reduction_plus:
+    case SgOmpClause::e_omp_reduction_minus:
+      op = V_SgAddOp; break;
+    case SgOmpClause::e_omp_reduction_mul:
+      op = V_SgMultiplyOp; break;
+    case SgOmpClause::e_omp_reduction_bitand:
+      op = V_SgBitAndOp; break;
+    case SgOmpClause::e_omp_reduction_bitor:
+      op = V_SgBitOrOp; break;
+    case SgOmpClause::e_omp_reduction_bitxor:
+      op = V_SgBitXorOp; break;
+    case SgOmpClause::e_omp_reduction_logand:
+      op = V_SgAndOp; break;
+    case SgOmpClause::e_omp_reduction_logor:
+      op = V_SgOrOp; break;
+    default:
+      break;
+  }
+  if (op != V_SgNode && isLockFreeUpdateType(orig_var->get_type()))
+  {
+    end_stmt_list.push_back(buildLockFreeUpdateStmt(op, buildVarRefExp(orig_var, bb1), buildVarRefExp(local_decl), false, bb1));
+    return;
+  }
+
 #ifdef ENABLE_XOMP
   SgExprStatement* atomic_start_stmt = buildFunctionCallStmt("XOMP_atomic_start", buildVoidType(), NULL, bb1); 
 #else  
@@ -2526,8 +2807,8 @@ static void insertOmpReductionCopyBackStmts (SgOmpClause::omp_reduction_operator
     case SgOmpClause::e_omp_reduction_mul:
       r_exp = buildMultiplyOp(buildVarRefExp(orig_var, bb1), buildVarRefExp(local_decl)); 
       break;
-    case SgOmpClause::e_omp_reduction_minus:
-      r_exp = buildSubtractOp(buildVarRefExp(orig_var, bb1), buildVarRefExp(local_decl)); 
+    case SgOmpClause::e_omp_reduction_minus: // partial results are added, see above
+      r_exp = buildAddOp(buildVarRefExp(orig_var, bb1), buildVarRefExp(local_decl)); 
       break;
     case SgOmpClause::e_omp_reduction_bitand:
       r_exp = buildBitAndOp(buildVarRefExp(orig_var, bb1), buildVarRefExp(local_decl)); 
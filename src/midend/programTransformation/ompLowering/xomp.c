@@ -23,6 +23,17 @@ extern int omp_get_num_threads(void);
 #include <stdarg.h>
 #include <string.h> // for memcpy()
 
+// Hooks of XOMP's own task scheduler (xomp_task.c), which is selected by linking libxomp_task.a before libxomp.a.
+// They are null otherwise, and XOMP_task() and XOMP_taskwait() below, which are weak, forward tasks to GOMP.
+// xomp_task_barrier() is called before every barrier; xomp_task_region_start() wraps the outlined function of a 
+// parallel region so that the tasks left at its end are run by the team.
+extern void xomp_task_barrier (void);
+extern void xomp_task_region_start (void (**func) (void *), void ** data);
+extern void xomp_task_region_end (void);
+#pragma weak xomp_task_barrier
+#pragma weak xomp_task_region_start
+#pragma weak xomp_task_region_end
+
 #if 0
 enum omp_rtl_enum {
   e_undefined,
@@ -180,6 +191,8 @@ void xomp_parallel_start (void (*func) (void *), unsigned* ifClauseValue, unsign
 
 void XOMP_parallel_start (void (*func) (void *), void *data, unsigned ifClauseValue, unsigned numThreadsSpecified)
 {
+  if (xomp_task_region_start)
+    xomp_task_region_start(&func, &data);
 
 #ifdef USE_ROSE_GOMP_OPENMP_LIBRARY 
   // XOMP  to GOMP
@@ -213,6 +226,8 @@ void XOMP_parallel_end (void)
   GOMP_parallel_end ();
 #else   
 #endif    
+  if (xomp_task_region_end)
+    xomp_task_region_end();
 }
 
 
@@ -268,6 +283,8 @@ void xomp_sections_end(void)
 /* Called after the current thread is told that all sections are executed. It synchronizes all threads also. */
 void XOMP_sections_end(void)
 {
+  if (xomp_task_barrier)
+    xomp_task_barrier();
 #ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
   GOMP_sections_end();
 #else
@@ -439,6 +456,7 @@ void xomp_task(void (*func) (void *), void (*cpyfn) (void *, void *), int* arg_s
   }
 }
 
+#pragma weak XOMP_task
 void XOMP_task (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
                        long arg_size, long arg_align, bool if_clause, unsigned untied)
 {
@@ -457,6 +475,7 @@ void XOMP_task (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
 #else
 #endif 
 }
+#pragma weak XOMP_taskwait
 void XOMP_taskwait (void)
 {
 #ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
@@ -1564,6 +1583,8 @@ void xomp_loop_end(void)
 }
 void XOMP_loop_end (void)
 {
+  if (xomp_task_barrier)
+    xomp_task_barrier();
 #ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
   GOMP_loop_end();
 #else   
@@ -1594,6 +1615,8 @@ void xomp_barrier(void)
 }
 void XOMP_barrier (void)
 {
+  if (xomp_task_barrier)
+    xomp_task_barrier();
 #ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
   GOMP_barrier();
 #else   
@@ -1692,6 +1715,54 @@ void XOMP_atomic_end (void)
 #endif
 }
 
+//---------
+// Compare-and-swap of floating point scalars, used by the compare-and-swap loops which the
+// translation generates for omp atomic and for reduction copy-back (integer and pointer scalars
+// use GCC's __sync builtins directly). newval is stored only if *target still holds the bits of
+// oldval, and true is returned if it was stored. A torn read of a double on a 32-bit target
+// just makes the compare-and-swap fail once.
+// Without compiler support the comparison and store are done under the atomic lock, which is then
+// used for all updates of float and double scalars.
+bool XOMP_atomic_cas_float (float* target, float oldval, float newval)
+{
+  union { float f; unsigned int u; } old_val, new_val;
+  old_val.f = oldval;
+  new_val.f = newval;
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_4)
+  return __sync_bool_compare_and_swap((unsigned int*)target, old_val.u, new_val.u);
+#else
+  bool stored = false;
+  XOMP_atomic_start();
+  if (*(unsigned int*)target == old_val.u)
+  {
+    *(unsigned int*)target = new_val.u;
+    stored = true;
+  }
+  XOMP_atomic_end();
+  return stored;
+#endif
+}
+
+bool XOMP_atomic_cas_double (double* target, double oldval, double newval)
+{
+  union { double d; unsigned long long u; } old_val, new_val;
+  old_val.d = oldval;
+  new_val.d = newval;
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_8)
+  return __sync_bool_compare_and_swap((unsigned long long*)target, old_val.u, new_val.u);
+#else
+  bool stored = false;
+  XOMP_atomic_start();
+  if (*(unsigned long long*)target == old_val.u)
+  {
+    *(unsigned long long*)target = new_val.u;
+    stored = true;
+  }
+  XOMP_atomic_end();
+  return stored;
+#endif
+}
+
 void XOMP_flush_all ()
 {
 #ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
@@ -0,0 +1,399 @@
+/*
+ * XOMP's own task scheduler, an alternative to forwarding XOMP_task() and XOMP_taskwait() to GOMP or Omni.
+ *
+ * It is selected at link time: this file is built into libxomp_task.a, whose XOMP_task() and XOMP_taskwait()
+ * override the weak versions in libxomp.a when it is linked first, e.g.
+ *
+ *    cc rose_fib.o -lxomp_task -lxomp libgomp.a -lpthread
+ *
+ * The code generated by ROSE's OpenMP lowering does not change.
+ *
+ * Design
+ *  - Each thread that creates or runs tasks owns a worker slot with a Chase-Lev deque: the owner pushes and pops
+ *    at the bottom without locks, idle threads steal from the top with one compare-and-swap.
+ *  - Task descriptors come from a per-worker free list and carry a small inline buffer for the task's data, so
+ *    creating a task normally does not call malloc().
+ *  - Cutoff: a task is run immediately by the creating thread when its if clause is false, when the team has a
+ *    single thread, or when the creating thread already has XOMP_TASK_CUTOFF (default 64, 0 for no limit) tasks
+ *    queued.  The last one keeps fine-grained recursive tasking (fib, quicksort) from paying for queueing once
+ *    there is enough parallelism.
+ *  - Waiting threads run other tasks.  XOMP_taskwait() runs tasks until the children of the current task are
+ *    finished, and xomp_task_barrier(), which xomp.c calls before each barrier, runs tasks until the whole team
+ *    has arrived and no task is left.  The same happens at the end of a parallel region: xomp.c lets
+ *    xomp_task_region_start() wrap the outlined function so that each thread calls xomp_task_barrier() after it.
+ *
+ *  All tasks run to completion on the thread that started them (untied tasks are treated as tied) and the
+ *  tied-task scheduling constraint is not enforced.  Tasks of nested teams share the deques, so a thread
+ *  waiting in one team may run tasks of another.
+ */
+#include "rose_config.h"
+#include "libxomp.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h> // for memcpy()
+#include <assert.h>
+
+// avoid include omp.h
+extern int omp_get_num_threads(void);
+
+// Maximum number of threads which can have a worker slot. Other threads run their tasks immediately.
+#define XOMP_TASK_MAX_WORKERS 256
+// Capacity of each deque, must be a power of 2. A task is run immediately if the deque is full.
+#define XOMP_TASK_DEQUE_SIZE 1024
+// Bytes of task data stored in the descriptor itself
+#define XOMP_TASK_INLINE_DATA 128
+// Default for the XOMP_TASK_CUTOFF environment variable
+#define XOMP_TASK_DEFAULT_CUTOFF 64
+
+typedef struct xomp_task
+{
+  void (*fn) (void *);
+  void * data;               // inline_data or a malloc'ed block
+  void * data_block;         // the malloc'ed block, if any
+  struct xomp_task* parent;
+  // 1 while the task is not finished + the number of unfinished children
+  // The descriptor is recycled when it drops to 0
+  volatile long refs;
+  struct xomp_task* next_free;
+  union { char bytes[XOMP_TASK_INLINE_DATA]; long double align; void* p; } inline_data;
+} xomp_task_t;
+
+// A parallel region, wrapping the outlined function and its data
+typedef struct xomp_task_region
+{
+  void (*func) (void *);
+  void * data;
+  // Number of threads which have ever arrived at xomp_task_barrier() in this region. Since the runtime's own
+  // barrier follows the hook, no thread can arrive for the next barrier before all have left the current one.
+  volatile long arrivals;
+  struct xomp_task_region* next_started; // the regions started by the same master, innermost first
+} xomp_task_region_t;
+
+typedef struct xomp_task_worker
+{
+  // Chase-Lev deque: the owner works at the bottom, thieves take from the top
+  volatile long top;
+  volatile long bottom;
+  xomp_task_t* volatile tasks[XOMP_TASK_DEQUE_SIZE];
+
+  xomp_task_t* current;      // the task being run, or &implicit_task
+  xomp_task_t implicit_task; // parent of the tasks created outside of any explicit task
+  xomp_task_t* free_list;    // recycled descriptors, only touched by the owner
+  unsigned seed;             // for choosing victims
+  char pad[64];              // keep neighbouring workers out of this one's cache lines
+} xomp_task_worker_t;
+
+static xomp_task_worker_t xomp_task_workers[XOMP_TASK_MAX_WORKERS];
+static volatile long xomp_task_worker_count = 0;
+// Deferred tasks created and not yet finished, for the barrier hooks
+static volatile long xomp_task_outstanding = 0;
+// Arrival count for barriers outside of any parallel region started through xomp_task_region_start()
+static volatile long xomp_task_barrier_arrivals = 0;
+static long xomp_task_cutoff = XOMP_TASK_DEFAULT_CUTOFF;
+
+static pthread_key_t xomp_task_worker_key;
+static pthread_key_t xomp_task_region_key;  // the region the thread is running
+static pthread_key_t xomp_task_started_key; // the innermost region started by the thread
+static pthread_once_t xomp_task_once = PTHREAD_ONCE_INIT;
+// Marks threads which did not get a worker slot
+static char xomp_task_no_worker;
+
+static void xomp_task_init_once(void)
+{
+  char* e_value = getenv("XOMP_TASK_CUTOFF");
+  pthread_key_create(&xomp_task_worker_key, NULL);
+  pthread_key_create(&xomp_task_region_key, NULL);
+  pthread_key_create(&xomp_task_started_key, NULL);
+  if (e_value != NULL)
+    xomp_task_cutoff = atol(e_value);
+}
+
+//! Return the calling thread's worker, registering the thread first if needed. NULL if all slots are taken.
+static xomp_task_worker_t* xomp_task_get_worker(void)
+{
+  void* w;
+  long id;
+  xomp_task_worker_t* worker;
+  pthread_once(&xomp_task_once, xomp_task_init_once);
+  w = pthread_getspecific(xomp_task_worker_key);
+  if (w != NULL)
+    return w == &xomp_task_no_worker ? NULL : (xomp_task_worker_t*) w;
+
+  id = __sync_fetch_and_add(&xomp_task_worker_count, 1);
+  if (id >= XOMP_TASK_MAX_WORKERS)
+  {
+    __sync_fetch_and_sub(&xomp_task_worker_count, 1);
+    pthread_setspecific(xomp_task_worker_key, &xomp_task_no_worker);
+    return NULL;
+  }
+  worker = &xomp_task_workers[id];
+  worker->implicit_task.refs = 1;
+  worker->current = &worker->implicit_task;
+  worker->seed = (unsigned) id * 2654435761u + 1;
+  pthread_setspecific(xomp_task_worker_key, worker);
+  return worker;
+}
+
+//------------------ Chase-Lev deque ------------------
+// The deque has a fixed capacity, so there is no growing and a thief can read a slot before claiming it.
+
+static int xomp_task_push(xomp_task_worker_t* w, xomp_task_t* task)
+{
+  long b = w->bottom;
+  long t = w->top;
+  if (b - t >= XOMP_TASK_DEQUE_SIZE)
+    return 0;
+  w->tasks[b & (XOMP_TASK_DEQUE_SIZE-1)] = task;
+  __sync_synchronize(); // the task must be visible before the new bottom
+  w->bottom = b + 1;
+  return 1;
+}
+
+static xomp_task_t* xomp_task_pop(xomp_task_worker_t* w)
+{
+  long b = w->bottom - 1;
+  long t;
+  xomp_task_t* task = NULL;
+  w->bottom = b;
+  __sync_synchronize(); // publish the new bottom before reading top
+  t = w->top;
+  if (t <= b)
+  {
+    task = w->tasks[b & (XOMP_TASK_DEQUE_SIZE-1)];
+    if (t == b)
+    { // last task: race against thieves for it
+      if (!__sync_bool_compare_and_swap(&w->top, t, t + 1))
+        task = NULL;
+      w->bottom = b + 1;
+    }
+  }
+  else
+    w->bottom = b + 1;
+  return task;
+}
+
+static xomp_task_t* xomp_task_steal(xomp_task_worker_t* w)
+{
+  long t = w->top;
+  long b;
+  xomp_task_t* task;
+  __sync_synchronize(); // read top before bottom
+  b = w->bottom;
+  if (t >= b)
+    return NULL;
+  task = w->tasks[t & (XOMP_TASK_DEQUE_SIZE-1)];
+  if (!__sync_bool_compare_and_swap(&w->top, t, t + 1))
+    return NULL;
+  return task;
+}
+
+//------------------ descriptors ------------------
+
+static xomp_task_t* xomp_task_alloc(xomp_task_worker_t* w)
+{
+  xomp_task_t* task = w != NULL ? w->free_list : NULL;
+  if (task != NULL)
+    w->free_list = task->next_free;
+  else
+  {
+    task = (xomp_task_t*) malloc(sizeof(xomp_task_t));
+    if (task == NULL)
+    {
+      printf("Error: XOMP_task(): out of memory for a task descriptor\n");
+      abort();
+    }
+  }
+  return task;
+}
+
+// Give the descriptor to the calling thread's free list; it need not be the thread which allocated it.
+static void xomp_task_free(xomp_task_worker_t* w, xomp_task_t* task)
+{
+  if (task->data_block != NULL)
+    free(task->data_block);
+  if (w != NULL)
+  {
+    task->next_free = w->free_list;
+    w->free_list = task;
+  }
+  else
+    free(task);
+}
+
+static void xomp_task_release(xomp_task_worker_t* w, xomp_task_t* task)
+{
+  if (__sync_sub_and_fetch(&task->refs, 1) == 0)
+    xomp_task_free(w, task);
+}
+
+//------------------ running tasks ------------------
+
+static void xomp_task_run(xomp_task_worker_t* w, xomp_task_t* task)
+{
+  xomp_task_t* saved = NULL;
+  xomp_task_t* parent = task->parent;
+  if (w != NULL)
+  {
+    saved = w->current;
+    w->current = task;
+  }
+  task->fn(task->data);
+  if (w != NULL)
+    w->current = saved;
+  xomp_task_release(w, task);
+  // An implicit task's count never drops to 0, so it is not recycled
+  if (parent != NULL)
+    xomp_task_release(w, parent);
+}
+
+// Run a deferred task: one from the worker's own deque, or one stolen from another worker. Return 0 if none was found.
+static int xomp_task_run_one(xomp_task_worker_t* w)
+{
+  xomp_task_t* task = xomp_task_pop(w);
+  if (task == NULL)
+  {
+    long n = xomp_task_worker_count;
+    long i;
+    if (n > XOMP_TASK_MAX_WORKERS)
+      n = XOMP_TASK_MAX_WORKERS;
+    w->seed = w->seed * 1103515245u + 12345u;
+    for (i = 0; i < n && task == NULL; i++)
+    {
+      xomp_task_worker_t* victim = &xomp_task_workers[(w->seed/65536 + i) % n];
+      if (victim != w)
+        task = xomp_task_steal(victim);
+    }
+  }
+  if (task == NULL)
+    return 0;
+  xomp_task_run(w, task);
+  __sync_fetch_and_sub(&xomp_task_outstanding, 1);
+  return 1;
+}
+
+// Copy the task data the same way GOMP does: with cpyfn if there is one, otherwise byte by byte
+static void xomp_task_copy_data(xomp_task_t* task, void *data, void (*cpyfn) (void *, void *), long arg_size, long arg_align)
+{
+  task->data_block = NULL;
+  if (arg_size <= 0)
+  {
+    task->data = NULL;
+    return;
+  }
+  if (arg_size <= XOMP_TASK_INLINE_DATA && arg_align <= (long) sizeof(task->inline_data.align))
+    task->data = task->inline_data.bytes;
+  else
+  {
+    if (arg_align < 1)
+      arg_align = 1;
+    task->data_block = malloc(arg_size + arg_align - 1);
+    if (task->data_block == NULL)
+    {
+      printf("Error: XOMP_task(): out of memory for %ld bytes of task data\n", arg_size);
+      abort();
+    }
+    task->data = (void*) (((unsigned long) task->data_block + arg_align - 1) & ~(unsigned long) (arg_align - 1));
+  }
+  if (cpyfn != NULL)
+    cpyfn(task->data, data);
+  else
+    memcpy(task->data, data, arg_size);
+}
+
+void XOMP_task (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
+                       long arg_size, long arg_align, bool if_clause, unsigned untied)
+{
+  xomp_task_worker_t* w = xomp_task_get_worker();
+  xomp_task_t* task = xomp_task_alloc(w);
+  int deferred;
+  task->fn = fn;
+  task->parent = w != NULL ? w->current : NULL;
+  task->refs = 1;
+  xomp_task_copy_data(task, data, cpyfn, arg_size, arg_align);
+  if (task->parent != NULL)
+    __sync_fetch_and_add(&task->parent->refs, 1);
+
+  // cutoff heuristics
+  deferred = w != NULL && if_clause && omp_get_num_threads() > 1 &&
+             (xomp_task_cutoff <= 0 || w->bottom - w->top < xomp_task_cutoff);
+  if (deferred)
+  {
+    __sync_fetch_and_add(&xomp_task_outstanding, 1);
+    if (xomp_task_push(w, task))
+      return;
+    __sync_fetch_and_sub(&xomp_task_outstanding, 1);
+  }
+  xomp_task_run(w, task);
+}
+
+void XOMP_taskwait (void)
+{
+  xomp_task_worker_t* w = xomp_task_get_worker();
+  xomp_task_t* current;
+  if (w == NULL)
+    return; // tasks created by this thread were all run immediately
+  current = w->current;
+  while (current->refs > 1)
+  {
+    if (!xomp_task_run_one(w))
+      sched_yield();
+  }
+}
+
+//! Hook called by xomp.c before each barrier: run tasks until all threads of the team are here and no task is left.
+void xomp_task_barrier (void)
+{
+  xomp_task_worker_t* w = xomp_task_get_worker();
+  xomp_task_region_t* region = (xomp_task_region_t*) pthread_getspecific(xomp_task_region_key);
+  volatile long* arrivals = region != NULL ? &region->arrivals : &xomp_task_barrier_arrivals;
+  long nthreads = omp_get_num_threads();
+  long target = (__sync_fetch_and_add(arrivals, 1) / nthreads + 1) * nthreads;
+  while (*arrivals < target || xomp_task_outstanding > 0)
+  {
+    if (w == NULL || !xomp_task_run_one(w))
+      sched_yield();
+  }
+}
+
+// Run by each thread of the team instead of the outlined function
+static void xomp_task_region_main (void* data)
+{
+  xomp_task_region_t* region = (xomp_task_region_t*) data;
+  void* saved = pthread_getspecific(xomp_task_region_key);
+  pthread_setspecific(xomp_task_region_key, region);
+  region->func(region->data);
+  xomp_task_barrier();
+  pthread_setspecific(xomp_task_region_key, saved);
+}
+
+//! Hook called by XOMP_parallel_start(): replace the outlined function and its data with a wrapper which runs 
+// the remaining tasks at the end of the region
+void xomp_task_region_start (void (**func) (void *), void ** data)
+{
+  xomp_task_region_t* region = (xomp_task_region_t*) malloc(sizeof(xomp_task_region_t));
+  if (region == NULL)
+  {
+    printf("Error: XOMP_parallel_start(): out of memory for a task region\n");
+    abort();
+  }
+  pthread_once(&xomp_task_once, xomp_task_init_once);
+  region->func = *func;
+  region->data = *data;
+  region->arrivals = 0;
+  region->next_started = (xomp_task_region_t*) pthread_getspecific(xomp_task_started_key);
+  pthread_setspecific(xomp_task_started_key, region);
+  *func = xomp_task_region_main;
+  *data = region;
+}
+
+//! Hook called by XOMP_parallel_end() after the team has finished
+void xomp_task_region_end (void)
+{
+  xomp_task_region_t* region = (xomp_task_region_t*) pthread_getspecific(xomp_task_started_key);
+  assert(region != NULL);
+  pthread_setspecific(xomp_task_started_key, region->next_started);
+  free(region);
+}
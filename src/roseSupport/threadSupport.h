@@ -89,9 +89,15 @@ enum RTS_Layer {
 
     /* ROSE library layers, 100-199 */
     RTS_LAYER_ROSE_CALLBACKS_LIST_OBJ   = 100,          /**< ROSE_Callbacks::List class */
+    RTS_LAYER_ASM_GENERIC_HEADER_CLASS  = 101,          /**< SgAsmGenericHeader section lookup indexes (a leaf lock, so it is
+                                                         *   below every layer whose locks may be held during a lookup) */
+    RTS_LAYER_PARTIAL_SYMBOLIC_SEMANTICS_CLASS = 102,   /**< PartialSymbolicSemantics value names (a leaf lock) */
     RTS_LAYER_RTS_MESSAGE_CLASS         = 105,          /**< RTS_Message class */
     RTS_LAYER_DISASSEMBLER_CLASS        = 110,          /**< Disassembler class */
     RTS_LAYER_ROSE_SMT_SOLVERS          = 115,          /**< SMTSolver class */
+    RTS_LAYER_MANGLED_NAME_CACHE_OBJ    = 120,          /**< MangledNameCache shards */
+    RTS_LAYER_FUNCTION_DRIVER_OBJ       = 125,          /**< BinaryAnalysis::FunctionDriver schedules */
+    RTS_LAYER_ASM_UNPARSER_OBJ          = 130,          /**< AsmUnparser parallel output and static data disassembly */
 
     /* Simulator layers (see projects/simulator), 200-220
      *
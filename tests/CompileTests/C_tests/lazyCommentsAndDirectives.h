@@ -0,0 +1,10 @@
+/* Shared by lazyCommentsAndDirectives1.c and lazyCommentsAndDirectives2.c */
+#ifndef LAZY_COMMENTS_AND_DIRECTIVES_H
+#define LAZY_COMMENTS_AND_DIRECTIVES_H
+
+#define SCALE 4
+
+/* Scales a value */
+int scale(int x);
+
+#endif
@@ -0,0 +1,19 @@
+/* Comments and CPP directives in a source file and in a header it includes. */
+#include <stddef.h>
+#include "lazyCommentsAndDirectives.h"
+
+// Before a function
+int scale(int x)
+   {
+  /* Inside the body */
+     return x * SCALE;  // After a statement
+   }
+
+#if 0
+int unused(void);
+#endif
+
+/* Before a variable */
+size_t n = sizeof(int);
+
+/* At the end of the file */
@@ -0,0 +1,13 @@
+// Includes the same header as lazyCommentsAndDirectives1.c
+#include "lazyCommentsAndDirectives.h"
+
+#define OFFSET 1
+
+int offset_and_scale(int x)
+   {
+#ifdef OFFSET
+     x += OFFSET;
+#endif
+  // Scale it
+     return scale(x);
+   }
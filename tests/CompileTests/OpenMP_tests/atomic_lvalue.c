@@ -0,0 +1,49 @@
+/* omp atomic updates of array elements, structure fields and dereferenced pointers.
+   Lock-free types are updated with compare-and-swap, also in the form x = x op expr. */
+#include <omp.h>
+#include <assert.h>
+
+struct counters
+{
+  int n;
+  double f;
+};
+
+int main (void)
+{
+  int a[4] = {0, 0, 0, 0};
+  double d[4] = {0.0, 0.0, 0.0, 0.0};
+  struct counters s = {0, 1.0};
+  int n = 0;
+  double x = 0.0;
+  int *p = &n;
+  double *q = &x;
+  int i = 2;
+  int nthreads = 0;
+
+#pragma omp parallel num_threads(4)
+  {
+#pragma omp single
+    nthreads = omp_get_num_threads();
+#pragma omp atomic
+    a[i] = a[i] + 1;
+#pragma omp atomic
+    d[i + 1] = 2.0 + d[i + 1];
+#pragma omp atomic
+    s.n = s.n + 3;
+#pragma omp atomic
+    s.f = s.f * 2;
+#pragma omp atomic
+    *p = *p + 1;
+#pragma omp atomic
+    *q = *q - 0.5;
+  }
+
+  assert (a[2] == nthreads);
+  assert (d[3] == 2.0 * nthreads);
+  assert (s.n == 3 * nthreads);
+  assert (s.f == (double)(1 << nthreads));
+  assert (n == nthreads);
+  assert (x == -0.5 * nthreads);
+  return 0;
+}
@@ -0,0 +1,170 @@
+/*
+Microbenchmark for the synchronization constructs, in the spirit of the EPCC 
+syncbench: atomic (int, double and mixed forms), critical, reduction (int and double) and barrier.
+
+Each construct is executed ITERS times by every thread of a parallel region and 
+the average time per execution is reported. The results of the updates are checked
+so that the test fails if a construct loses updates.
+
+Usage: syncbench [ITERS]     (default 10000, kept small for make check)
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+static double now(void)
+{
+#ifdef _OPENMP
+  return omp_get_wtime();
+#else
+  return 0.0;
+#endif
+}
+
+static void report(const char* name, double elapsed, long iters)
+{
+  printf("%-18s %10.3f us\n", name, 1.0e6 * elapsed / iters);
+}
+
+int main(int argc, char* argv[])
+{
+  long iters = argc > 1 ? atol(argv[1]) : 10000;
+  long i;
+  int nthreads = 1;
+  int errors = 0;
+  int isum = 0;
+  double dsum = 0.0;
+  int critical_count = 0;
+  long msum = 0;
+  long rsum = 0;
+  double rdsum = 0.0;
+  double t0;
+
+#pragma omp parallel
+  {
+#pragma omp master
+    {
+#ifdef _OPENMP
+      nthreads = omp_get_num_threads();
+#endif
+    }
+  }
+  printf("syncbench: %d threads, %ld iterations\n", nthreads, iters);
+
+  t0 = now();
+#pragma omp parallel private(i)
+  {
+    for (i = 0; i < iters; i++)
+    {
+#pragma omp atomic
+      isum += 1;
+    }
+  }
+  report("atomic int", now() - t0, iters);
+  if (isum != nthreads * iters)
+  {
+    printf("atomic int: %d instead of %ld\n", isum, nthreads * iters);
+    errors++;
+  }
+
+  t0 = now();
+#pragma omp parallel private(i)
+  {
+    for (i = 0; i < iters; i++)
+    {
+#pragma omp atomic
+      dsum += 0.5;
+    }
+  }
+  report("atomic double", now() - t0, iters);
+  if (dsum != 0.5 * nthreads * iters)
+  {
+    printf("atomic double: %f instead of %f\n", dsum, 0.5 * nthreads * iters);
+    errors++;
+  }
+
+  /* Different forms of atomic updates of the same variable must be atomic with respect to each other.
+     msum - 1.5 is computed in double and truncated, so each iteration adds 3 and then takes 2 away */
+  t0 = now();
+#pragma omp parallel private(i)
+  {
+    for (i = 0; i < iters; i++)
+    {
+#pragma omp atomic
+      msum += 3;
+#pragma omp atomic
+      msum *= 1;
+#pragma omp atomic
+      msum -= 1.5;
+#pragma omp atomic
+      msum = msum / 1;
+    }
+  }
+  report("atomic mixed", now() - t0, iters);
+  if (msum != nthreads * iters)
+  {
+    printf("atomic mixed: %ld instead of %ld\n", msum, nthreads * iters);
+    errors++;
+  }
+
+  t0 = now();
+#pragma omp parallel private(i)
+  {
+    for (i = 0; i < iters; i++)
+    {
+#pragma omp critical
+      critical_count = critical_count + 1;
+    }
+  }
+  report("critical", now() - t0, iters);
+  if (critical_count != nthreads * iters)
+  {
+    printf("critical: %d instead of %ld\n", critical_count, nthreads * iters);
+    errors++;
+  }
+
+  /* One reduction per parallel region, as in a reduction-heavy kernel called in a loop */
+  t0 = now();
+  for (i = 0; i < iters; i++)
+  {
+#pragma omp parallel reduction(+:rsum)
+    {
+      rsum = rsum + 1;
+    }
+  }
+  report("reduction int", now() - t0, iters);
+  if (rsum != (long)nthreads * iters)
+  {
+    printf("reduction int: %ld instead of %ld\n", rsum, nthreads * iters);
+    errors++;
+  }
+
+  t0 = now();
+  for (i = 0; i < iters; i++)
+  {
+#pragma omp parallel reduction(+:rdsum)
+    {
+      rdsum = rdsum + 0.25;
+    }
+  }
+  report("reduction double", now() - t0, iters);
+  if (rdsum != 0.25 * nthreads * iters)
+  {
+    printf("reduction double: %f instead of %f\n", rdsum, 0.25 * nthreads * iters);
+    errors++;
+  }
+
+  t0 = now();
+#pragma omp parallel private(i)
+  {
+    for (i = 0; i < iters; i++)
+    {
+#pragma omp barrier
+    }
+  }
+  report("barrier", now() - t0, iters);
+
+  return errors != 0;
+}
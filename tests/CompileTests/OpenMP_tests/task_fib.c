@@ -0,0 +1,52 @@
+/*
+Fine-grained recursive tasking: every call of fib() creates two tasks and waits for them.
+The run time is dominated by the cost of creating and scheduling tasks.
+Returns non-zero if the result is wrong.
+
+Usage: task_fib [N]     (default 25)
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+int fib(int n)
+{
+  int x, y;
+  if (n < 2)
+    return n;
+#pragma omp task shared(x) firstprivate(n)
+  x = fib(n - 1);
+#pragma omp task shared(y) firstprivate(n)
+  y = fib(n - 2);
+#pragma omp taskwait
+  return x + y;
+}
+
+int main(int argc, char* argv[])
+{
+  int n = argc > 1 ? atoi(argv[1]) : 25;
+  int i, expected = 0, next = 1, result = 0;
+  double t0 = 0.0;
+  for (i = 0; i < n; i++)
+  {
+    int t = expected + next;
+    expected = next;
+    next = t;
+  }
+#ifdef _OPENMP
+  t0 = omp_get_wtime();
+#endif
+#pragma omp parallel
+  {
+#pragma omp single
+    result = fib(n);
+  }
+#ifdef _OPENMP
+  printf("fib(%d) = %d in %.3f seconds\n", n, result, omp_get_wtime() - t0);
+#else
+  printf("fib(%d) = %d\n", n, result);
+#endif
+  return result != expected;
+}